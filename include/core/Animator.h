@@ -0,0 +1,103 @@
+#pragma once
+
+#include <core/Texture.h>
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+typedef Uint32 AnimationInstance;
+
+struct RenderQueue;
+
+struct AnimationFrame {
+	SDL_Rect clip;
+	Uint32 end;
+};
+
+struct AnimationMarker {
+	std::string name;
+	Uint32 time;
+};
+
+struct AnimationClip {
+	std::string name;
+	bool loop;
+	Uint32 length;
+	Uint32 firstFrame;
+	Uint32 numFrames;
+	Uint32 firstMarker;
+	Uint32 numMarkers;
+};
+
+// Sprite sheet clips read from a text file, one declaration per line, '#'
+// starts a comment:
+//   clip <name> <loop|once>
+//   frame <x> <y> <w> <h> <milliseconds>
+//   marker <name> <milliseconds from clip start>
+// Frames and markers belong to the clip declared above them and are stored
+// back to back for every clip.
+struct AnimationSet {
+public:
+	bool load(std::string path);
+	void clear();
+	int findClip(const std::string& name);
+	int getNumClips();
+	const AnimationClip& getClip(int clip);
+	const AnimationFrame& getFrame(int clip, int frame);
+	const AnimationMarker& getMarker(int clip, int marker);
+
+private:
+	bool parseLine(const std::string& line, int lineNumber);
+
+private:
+	std::vector<AnimationClip> clips;
+	std::vector<AnimationFrame> frames;
+	std::vector<AnimationMarker> markers;
+};
+
+struct AnimationEvent {
+	AnimationInstance instance;
+	const std::string* marker;
+};
+
+// Plays clips of one AnimationSet on any number of instances. Playback state
+// lives in parallel arrays and update() advances all of it in one pass by
+// elapsed time, collecting the markers crossed since the previous update.
+// render() and record() draw every instance at its current frame.
+struct Animator {
+public:
+	Animator();
+	void init(AnimationSet* set);
+	AnimationInstance play(int clip, Texture* texture, int x, int y, float speed = 1.0f);
+	void stop(AnimationInstance instance);
+	void clear();
+	bool isPlaying(AnimationInstance instance);
+	bool isFinished(AnimationInstance instance);
+	int getNumInstances();
+	void setClip(AnimationInstance instance, int clip);
+	void setPosition(AnimationInstance instance, int x, int y);
+	void setSpeed(AnimationInstance instance, float speed);
+	const SDL_Rect& getFrameClip(AnimationInstance instance);
+	void update(Uint32 elapsedTicks);
+	const std::vector<AnimationEvent>& getEvents();
+	void render(SDL_Renderer* renderer);
+	void record(RenderQueue& queue, Uint8 layer);
+
+private:
+	void fireMarkers(int index, float from, float to, bool inclusive);
+
+private:
+	AnimationSet* set;
+	std::vector<Uint16> clips;
+	std::vector<Uint16> frames;
+	std::vector<float> times;
+	std::vector<float> speeds;
+	std::vector<Uint8> finished;
+	std::vector<int> posX;
+	std::vector<int> posY;
+	std::vector<Texture*> textures;
+	std::vector<AnimationInstance> instances;
+	std::vector<int> indices;
+	std::vector<AnimationInstance> freeInstances;
+	std::vector<AnimationEvent> events;
+};
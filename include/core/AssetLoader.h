@@ -0,0 +1,65 @@
+#pragma once
+
+#include <SDL.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+struct AssetBuffer {
+	std::string path;
+	std::string fallbackPath;
+	const Uint8* data = nullptr;
+	size_t size = 0;
+	bool loaded = false;
+	void* result = nullptr;
+};
+
+typedef void* (*AssetDecodeFunction)(const AssetBuffer& buffer, void* userdata);
+
+struct IoUring;
+struct Texture;
+
+// Loads a whole batch of files at once. On Linux builds with SDL_TEST_IO_URING
+// every read is submitted through one io_uring into a single registered buffer
+// and finished buffers go straight to the decode workers; otherwise, or when
+// the kernel refuses io_uring, the workers read the files themselves. A buffer
+// whose path does not exist is read from its fallbackPath, which then becomes
+// its path.
+struct AssetLoader {
+public:
+	AssetLoader();
+	~AssetLoader();
+	bool init(int numWorkers = 0);
+	bool load(std::vector<AssetBuffer>& buffers, AssetDecodeFunction decode, void* userdata);
+	bool loadSurfaces(const std::vector<std::string>& paths, std::vector<SDL_Surface*>& surfaces);
+	bool loadTextures(SDL_Renderer* renderer, const std::vector<std::string>& paths, const std::vector<Texture*>& textures);
+	void free();
+	bool isUsingIoUring();
+
+private:
+	struct Task {
+		int index;
+		Uint8* destination;
+	};
+
+	static int workerThread(void* data);
+	static SDL_Surface* decodeSurface(const AssetBuffer& buffer);
+	static bool locate(AssetBuffer& buffer);
+	static bool readFile(AssetBuffer& buffer, Uint8* destination);
+	void push(int index, Uint8* destination);
+	bool submitReads(std::vector<int>& pending, std::vector<Uint8*>& destinations);
+
+private:
+	std::vector<SDL_Thread*> workers;
+	SDL_mutex* mutex;
+	SDL_cond* taskCondition;
+	SDL_cond* doneCondition;
+	std::deque<Task> tasks;
+	int numUnfinished;
+	bool quitting;
+	IoUring* ring;
+	std::vector<AssetBuffer>* currentBuffers;
+	AssetDecodeFunction currentDecode;
+	void* currentUserdata;
+	std::vector<Uint8> arena;
+};
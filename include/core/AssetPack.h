@@ -0,0 +1,56 @@
+#pragma once
+
+#include <core/MappedFile.h>
+#include <SDL.h>
+#include <string>
+
+const char* const ASSET_PACK_PATH = "assets.pack";
+
+struct PackHeader {
+	Uint32 magic;
+	Uint32 version;
+	Uint32 numEntries;
+	Uint32 reserved;
+	Uint64 namesOffset;
+	Uint64 dataOffset;
+};
+
+struct PackEntry {
+	Uint64 hash;
+	Uint64 offset;
+	Uint64 size;
+	Uint32 nameOffset;
+	Uint32 nameLength;
+};
+
+// Read-only view of a pack built by the asset_pack tool: a PackHeader, an
+// index of PackEntry sorted by name hash, a name table and the file contents.
+// The pack is mapped once; assets are handed out as SDL_RWops over the mapping.
+struct AssetPack {
+public:
+	AssetPack();
+	bool open(std::string path);
+	void close();
+	bool contains(std::string name);
+	SDL_RWops* openAsset(std::string name);
+	static bool mount(std::string path);
+	static void unmount();
+	static SDL_RWops* openFile(std::string path);
+	static bool findMounted(std::string path, const Uint8** data, size_t* size);
+	static Uint64 hash(const std::string& name);
+
+public:
+	static constexpr Uint32 PACK_MAGIC = SDL_FOURCC('S', 'D', 'L', 'P');
+	static constexpr Uint32 PACK_VERSION = 1;
+	static constexpr Uint64 PACK_ALIGNMENT = 16;
+
+private:
+	const PackEntry* find(const std::string& name);
+
+private:
+	MappedFile file;
+	const PackHeader* header;
+	const PackEntry* entries;
+	const char* names;
+	static AssetPack* mounted;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+struct SaveHeader {
+	Uint32 magic;
+	Uint32 version;
+	Uint64 payloadSize;
+	Uint32 checksum;
+	Uint32 reserved;
+};
+
+// Write-behind saver. save() only copies the snapshot into a pending buffer;
+// a worker thread checksums it, writes it to "<path>.tmp" with a SaveHeader, fsyncs and
+// renames it over <path>. Newer snapshots replace pending ones that were not
+// written yet.
+struct AsyncSaver {
+public:
+	AsyncSaver();
+	~AsyncSaver();
+	bool init();
+	bool save(std::string path, Uint32 version, const void* data, size_t size);
+	void free();
+	int getNumSaved();
+	int getNumFailed();
+	static bool load(std::string path, Uint32 version, std::vector<Uint8>& payload);
+	static Uint32 checksum(const Uint8* data, size_t size);
+
+public:
+	static constexpr Uint32 SAVE_MAGIC = SDL_FOURCC('S', 'D', 'L', 'S');
+
+private:
+	static int workerThread(void* data);
+	static bool writeAtomically(const std::string& path, const std::vector<Uint8>& buffer);
+
+private:
+	SDL_Thread* worker;
+	SDL_mutex* mutex;
+	SDL_cond* condition;
+	std::string pendingPath;
+	std::vector<Uint8> pendingBuffer;
+	std::vector<Uint8> writingBuffer;
+	bool pending;
+	bool quitting;
+	SDL_atomic_t numSaved;
+	SDL_atomic_t numFailed;
+};
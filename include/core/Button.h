@@ -17,6 +17,10 @@ public:
 	void setSize(int w, int h);
 	void setPosition(int x, int y);
 	void handleEvent(SDL_Event* e);
+	bool contains(int x, int y);
+	SDL_Rect getRect();
+	void setSprite(ButtonSprite sprite);
+	ButtonSprite getSprite();
 	void render(SDL_Renderer* renderer, Texture* buttonSpriteSheetTexture, SDL_Rect* buttonClips);
 
 private:
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <SDL.h>
+#include <string>
+
+enum CookedCompression {
+	COOKED_COMPRESSION_NONE = 0,
+	COOKED_COMPRESSION_RLE = 1
+};
+
+struct CookedTextureHeader {
+	Uint32 magic;
+	Uint32 version;
+	Uint32 format;
+	Uint32 compression;
+	Sint32 width;
+	Sint32 height;
+	Sint32 pitch;
+	Uint32 dataSize;
+};
+
+// Textures produced by the asset_cook tool: 32-bit pixels with the cyan color
+// key already turned into alpha, stored raw or as (count, pixel) runs, so the
+// loader can hand them to SDL_UpdateTexture without decoding or converting.
+struct CookedTexture {
+public:
+	static std::string getCookedPath(std::string path);
+	static SDL_Surface* bake(SDL_Surface* surface, Uint32 format);
+	static bool save(SDL_Surface* surface, std::string path, bool compress);
+	static SDL_Texture* load(SDL_Renderer* renderer, SDL_RWops* file, int* width, int* height);
+
+public:
+	static constexpr Uint32 COOKED_MAGIC = SDL_FOURCC('S', 'D', 'L', 'T');
+	static constexpr Uint32 COOKED_VERSION = 1;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <core/Texture.h>
+#include <SDL.h>
+#include <vector>
+
+typedef Uint32 Entity;
+
+struct RenderQueue;
+
+enum EntityFlags {
+	ENTITY_FLAG_NONE = 0,
+	// Reflect the velocity on a blocked axis instead of stopping there.
+	ENTITY_FLAG_BOUNCE = 1 << 0,
+	// Other entities are pushed back by it in collide().
+	ENTITY_FLAG_SOLID = 1 << 1,
+};
+
+// Copy of what EntityStore::render() reads, so a render thread can draw one
+// simulation step while the store is already computing the next.
+struct EntitySnapshot {
+public:
+	void render(SDL_Renderer* renderer, const SDL_Rect& camera) const;
+	void record(RenderQueue& queue, const SDL_Rect& camera) const;
+
+private:
+	friend struct EntityStore;
+	std::vector<int> posX;
+	std::vector<int> posY;
+	std::vector<int> width;
+	std::vector<int> height;
+	std::vector<Texture*> textures;
+	std::vector<Uint8> layers;
+};
+
+// Entities kept as parallel component arrays (position, velocity, size,
+// texture, flags, draw layer) instead of one object each, so the systems below walk
+// contiguous memory and split the work across the JobSystem. move() keeps
+// entities inside the bounds and out of the static colliders, collide()
+// resolves overlaps with solid entities through a uniform grid, and render()
+// draws the visible ones on the calling thread.
+struct EntityStore {
+public:
+	EntityStore();
+	Entity create(int x, int y, int width, int height, Texture* texture, Uint32 flags = ENTITY_FLAG_NONE, Uint8 layer = 0);
+	void destroy(Entity entity);
+	void clear();
+	bool isAlive(Entity entity);
+	int getNumEntities();
+	int getPosX(Entity entity);
+	int getPosY(Entity entity);
+	void setVelocity(Entity entity, int velX, int velY);
+	void handleEvent(Entity entity, SDL_Event& e, int speed);
+	void setBounds(const SDL_Rect& bounds);
+	void setColliders(const std::vector<SDL_Rect>& colliders);
+	void move();
+	void collide();
+	void render(SDL_Renderer* renderer, const SDL_Rect& camera);
+	void snapshot(EntitySnapshot& snapshot);
+
+	static void handleArrowKeys(SDL_Event& e, int speed, int& velX, int& velY);
+
+private:
+	enum Contact {
+		CONTACT_LEFT = 1 << 0,
+		CONTACT_RIGHT = 1 << 1,
+		CONTACT_UP = 1 << 2,
+		CONTACT_DOWN = 1 << 3,
+	};
+
+	bool isBlocked(int index);
+	void buildGrid();
+	int getCell(int position, int origin, int numCells);
+	Uint8 findContacts(int index);
+	void resolveContacts(int index, Uint8 contact);
+
+private:
+	std::vector<int> posX;
+	std::vector<int> posY;
+	std::vector<int> prevX;
+	std::vector<int> prevY;
+	std::vector<int> velX;
+	std::vector<int> velY;
+	std::vector<int> width;
+	std::vector<int> height;
+	std::vector<Texture*> textures;
+	std::vector<Uint32> flags;
+	std::vector<Uint8> layers;
+	std::vector<Uint8> contacts;
+	std::vector<Entity> entities;
+	std::vector<int> indices;
+	std::vector<Entity> freeEntities;
+	std::vector<SDL_Rect> colliders;
+	SDL_Rect bounds;
+	int cellSize;
+	int numCellsX;
+	int numCellsY;
+	std::vector<int> cellStart;
+	std::vector<int> cellEntities;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <SDL.h>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+typedef std::function<void(SDL_Event& event)> EventHandler;
+
+// Drains the SDL queue in bulk once per frame and hands every event only to the
+// handlers registered for its type, and for its window when the handler is bound
+// to one. Consecutive mouse motion in the same window collapses into one event
+// that carries the final position and the summed relative motion.
+struct EventBus {
+public:
+	EventBus();
+	int subscribe(Uint32 type, EventHandler handler);
+	int subscribe(Uint32 type, Uint32 windowID, EventHandler handler);
+	void unsubscribe(int id);
+	void setCoalesceMouseMotion(bool coalesce);
+	int dispatch();
+	int getNumDispatched();
+	int getNumCoalesced();
+	static Uint32 getWindowID(const SDL_Event& event);
+
+public:
+	static constexpr int EVENT_BATCH_SIZE = 64;
+
+private:
+	struct Handler {
+		int id;
+		EventHandler function;
+	};
+
+	void drain();
+	void coalesce();
+	void deliver(Uint64 key, SDL_Event& event);
+	void compact();
+	static Uint64 makeKey(Uint32 type, Uint32 windowID);
+
+private:
+	std::unordered_map<Uint64, std::vector<Handler>> handlers;
+	std::unordered_map<int, Uint64> handlerKeys;
+	std::vector<SDL_Event> events;
+	int nextID;
+	bool coalesceMouseMotion;
+	bool needsCompact;
+	int numDispatched;
+	int numCoalesced;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <SDL.h>
+#include <deque>
+#include <functional>
+#include <vector>
+
+typedef std::function<void()> JobFunction;
+typedef std::function<void(int begin, int end)> RangeFunction;
+
+struct JobCounter;
+
+struct Job {
+	JobFunction function;
+	JobCounter* counter;
+};
+
+// Number of unfinished jobs submitted against it. Jobs submitted with a counter
+// as their dependency are held back until it drops to zero, which chains the
+// phases of a frame (update, then collide, then prepare) without blocking.
+struct JobCounter {
+public:
+	JobCounter();
+	bool isDone();
+
+private:
+	friend struct JobSystem;
+	SDL_atomic_t pending;
+	SDL_SpinLock lock;
+	std::vector<Job> continuations;
+};
+
+// Work-stealing job system. Every worker owns a deque it pushes to and pops
+// from at the back; idle workers steal from the front of the others, and jobs
+// from other threads (the main thread) go to a shared deque. Waiting threads
+// run jobs instead of sleeping, so with no workers everything still completes
+// inside wait() and parallelFor(). SDL rendering stays on the main thread.
+struct JobSystem {
+public:
+	static bool init(int numWorkers = -1);
+	static void quit();
+	static void submit(JobFunction function, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+	static void wait(JobCounter* counter);
+	static void parallelFor(int count, RangeFunction function, int grainSize = 0);
+	static int getNumThreads();
+
+private:
+	struct WorkerQueue {
+		SDL_SpinLock lock = 0;
+		std::deque<Job> jobs;
+	};
+
+	static int workerThread(void* data);
+	static void push(Job& job);
+	static bool pop(Job& job);
+	static void execute(Job& job);
+	static void finish(JobCounter* counter);
+
+private:
+	static std::vector<WorkerQueue*> queues;
+	static std::vector<SDL_Thread*> workers;
+	static SDL_sem* semaphore;
+	static SDL_atomic_t quitting;
+	static thread_local int currentQueue;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <core/MappedFile.h>
+#include <SDL.h>
+#include <string>
+
+// Uncompressed 24 or 32-bit BMP read straight from a file mapping (or a mounted
+// asset pack). A top-down bitmap whose pixels already match the requested format
+// and start on a 4-byte boundary is wrapped with SDL_CreateRGBSurfaceFrom and
+// never copied, so the surface is read-only and only valid while the bitmap
+// stays loaded. Anything else is
+// converted once from the mapping into a surface of the requested format, and
+// other BMP variants go through SDL_LoadBMP_RW and SDL_ConvertSurface.
+struct MappedBitmap {
+public:
+	MappedBitmap();
+	~MappedBitmap();
+	bool load(std::string path, const SDL_PixelFormat* format);
+	void free();
+	SDL_Surface* getSurface();
+	bool isZeroCopy();
+
+private:
+	bool loadMapped(const Uint8* data, size_t size, const SDL_PixelFormat* format);
+
+private:
+	MappedFile file;
+	SDL_Surface* surface;
+	bool zeroCopy;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <SDL.h>
+#include <string>
+
+struct MappedFile {
+public:
+	MappedFile();
+	~MappedFile();
+	bool open(std::string path, bool writable, Sint64 minSize = 0);
+	bool resize(Sint64 newSize);
+	void flush();
+	void prefetch();
+	void close();
+	SDL_RWops* createRWops();
+	Uint8* getData();
+	Sint64 getSize();
+	bool isOpen();
+	bool isWritable();
+
+private:
+	bool map();
+	void unmap();
+
+private:
+	Uint8* data;
+	Sint64 size;
+	bool writable;
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#else
+	int fileDescriptor;
+#endif
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <SDL.h>
+#include <core/Window.h>
+#include <vector>
+
+// Presents a set of windows once per frame against a single vsync. The first
+// visible window created with vsync paces the frame and presents last, while
+// the others are created without vsync and present without blocking, so
+// adding windows does not divide the frame rate. Hidden and minimized windows
+// are drawn only when they need a redraw. With no pacing window visible,
+// frames are paced by a timer at the refresh rate of the first window.
+struct PresentScheduler {
+public:
+	PresentScheduler();
+	void add(WindowEx* window);
+	void clear();
+	void present();
+	void printStatistics();
+
+private:
+	WindowEx* findPacer();
+	void waitForNextFrame();
+
+private:
+	std::vector<WindowEx*> windows;
+	Uint64 nextFrame;
+	Uint64 numFrames;
+	Uint64 numPresents;
+	Uint64 numTimedFrames;
+};
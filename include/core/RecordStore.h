@@ -0,0 +1,48 @@
+#pragma once
+
+#include <core/MappedFile.h>
+#include <type_traits>
+
+// Array view over a file of raw, native-endian T records. Only the pages that
+// are touched get read in, so opening and indexing cost does not depend on the
+// number of records.
+template <typename T>
+struct RecordStore {
+public:
+	static_assert(std::is_trivially_copyable<T>::value, "Records must be trivially copyable");
+
+	bool open(std::string path, Sint64 minCount = 0) {
+		return file.open(path, true, minCount * static_cast<Sint64>(sizeof(T)));
+	}
+
+	bool resize(Sint64 count) {
+		return file.resize(count * static_cast<Sint64>(sizeof(T)));
+	}
+
+	void flush() {
+		file.flush();
+	}
+
+	void close() {
+		file.close();
+	}
+
+	SDL_RWops* createRWops() {
+		return file.createRWops();
+	}
+
+	Sint64 getCount() {
+		return file.getSize() / static_cast<Sint64>(sizeof(T));
+	}
+
+	T* getData() {
+		return reinterpret_cast<T*>(file.getData());
+	}
+
+	T& operator[](Sint64 index) {
+		return reinterpret_cast<T*>(file.getData())[index];
+	}
+
+private:
+	MappedFile file;
+};
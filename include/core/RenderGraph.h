@@ -0,0 +1,79 @@
+#pragma once
+
+#include <SDL.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+typedef int RenderGraphResource;
+typedef std::function<void(SDL_Renderer* renderer)> RenderPassFunction;
+
+const RenderGraphResource RENDER_GRAPH_BACKBUFFER = 0;
+
+// Passes declared for one frame with the targets they read and the one they
+// draw into. execute() drops every pass whose output never reaches the
+// backbuffer, then runs the rest in declaration order. Transient targets are
+// taken from a pool when first used and returned after their last reader, so
+// targets with disjoint lifetimes share one texture; pooled textures unused
+// for POOL_FRAMES frames are destroyed. Without render-target support only
+// passes drawing to the backbuffer run and getTexture() returns nullptr.
+struct RenderGraph {
+public:
+	RenderGraph();
+	~RenderGraph();
+	bool init(SDL_Renderer* renderer);
+	void free();
+	bool supportsTargets();
+	RenderGraphResource createTarget(int width, int height, SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND);
+	void addPass(std::string name, std::vector<RenderGraphResource> inputs, RenderGraphResource output, RenderPassFunction function);
+	SDL_Texture* getTexture(RenderGraphResource resource);
+	void execute();
+	void printStatistics();
+	int getNumPooled();
+
+public:
+	static constexpr Uint64 POOL_FRAMES = 60;
+
+private:
+	struct Resource {
+		int width;
+		int height;
+		SDL_BlendMode blendMode;
+		SDL_Texture* texture;
+		int firstPass;
+		int lastPass;
+	};
+
+	struct Pass {
+		std::string name;
+		std::vector<RenderGraphResource> inputs;
+		RenderGraphResource output;
+		RenderPassFunction function;
+		bool live;
+	};
+
+	struct PooledTarget {
+		SDL_Texture* texture;
+		int width;
+		int height;
+		Uint64 lastUsedFrame;
+		bool inUse;
+	};
+
+	void cull();
+	void computeLifetimes();
+	bool acquire(Resource& resource);
+	void release(Resource& resource);
+	void trimPool();
+
+private:
+	SDL_Renderer* renderer;
+	bool targetsSupported;
+	std::vector<Resource> resources;
+	std::vector<Pass> passes;
+	std::vector<PooledTarget> pool;
+	Uint64 numFrames;
+	Uint64 numPasses;
+	Uint64 numCulled;
+	Uint64 numCreated;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <SDL.h>
+#include <functional>
+
+typedef std::function<void(SDL_Renderer* renderer)> LayerPainter;
+
+// Static or rarely-changing content kept in one render-target texture. The
+// painter runs only after invalidate() (or when the renderer loses its
+// targets, and after a device reset into a new texture), and every other
+// frame costs a single copy of the texture. Paints directly every frame when
+// the renderer has no render-target support.
+struct RenderLayer {
+public:
+	RenderLayer();
+	~RenderLayer();
+	bool init(SDL_Renderer* renderer, int width, int height, LayerPainter paint, SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND);
+	void invalidate();
+	void handleEvent(SDL_Event& event);
+	void render(int x = 0, int y = 0);
+	void free();
+	bool isCached();
+	int getNumRepainted();
+
+private:
+	void createTexture();
+	bool repaint();
+
+private:
+	SDL_Renderer* renderer;
+	SDL_Texture* texture;
+	LayerPainter paint;
+	SDL_BlendMode blendMode;
+	int width;
+	int height;
+	bool dirty;
+	int numRepainted;
+};
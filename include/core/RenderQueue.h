@@ -0,0 +1,79 @@
+#pragma once
+
+#include <core/Texture.h>
+#include <SDL.h>
+#include <functional>
+#include <vector>
+
+enum RenderCommandType {
+	RENDER_COMMAND_SPRITE,
+	RENDER_COMMAND_FILL_RECT,
+	RENDER_COMMAND_DRAW_RECT,
+	RENDER_COMMAND_DRAW_LINE,
+};
+
+// One recorded draw. Sprites keep the texture's own color and blend state;
+// shapes carry theirs. Lines store their end points in rect.x/y and rect.w/h.
+struct RenderCommand {
+	Uint8 type;
+	Uint8 layer;
+	bool clipped;
+	SDL_RendererFlip flip;
+	SDL_BlendMode blendMode;
+	SDL_Color color;
+	Texture* texture;
+	SDL_Rect rect;
+	SDL_Rect clip;
+	double angle;
+};
+
+// Draw calls recorded for later instead of issued to the renderer, so any
+// thread can fill one. Lower layers are drawn first; within a layer the
+// queue is free to reorder commands to group textures and draw state.
+struct CommandBuffer {
+public:
+	void clear();
+	int getNumCommands();
+	void drawSprite(Uint8 layer, Texture* texture, int x, int y, const SDL_Rect* clip = nullptr, double angle = 0.0, SDL_RendererFlip flip = SDL_FLIP_NONE);
+	void fillRect(Uint8 layer, const SDL_Rect& rect, SDL_Color color, SDL_BlendMode blendMode = SDL_BLENDMODE_NONE);
+	void drawRect(Uint8 layer, const SDL_Rect& rect, SDL_Color color, SDL_BlendMode blendMode = SDL_BLENDMODE_NONE);
+	void drawLine(Uint8 layer, int x1, int y1, int x2, int y2, SDL_Color color, SDL_BlendMode blendMode = SDL_BLENDMODE_NONE);
+
+private:
+	friend struct RenderQueue;
+	Uint64 order = 0;
+	std::vector<RenderCommand> commands;
+};
+
+typedef std::function<void(CommandBuffer& buffer, int begin, int end)> RecordFunction;
+
+// Collects command buffers from any thread and replays them on the main
+// thread. record() splits a range across the JobSystem with one buffer per
+// chunk. submit() merges the buffers in the order they were begun (the chunks
+// of one record() call by range), stable-sorts by layer, texture and draw
+// state, and only touches the renderer's color and blend mode when they
+// actually change.
+struct RenderQueue {
+public:
+	RenderQueue();
+	~RenderQueue();
+	CommandBuffer* beginBuffer();
+	void endBuffer(CommandBuffer* buffer);
+	void record(int count, RecordFunction function);
+	void submit(SDL_Renderer* renderer);
+	void printStatistics();
+
+private:
+	CommandBuffer* acquireBuffer(Uint64 order);
+	void replay(SDL_Renderer* renderer);
+
+private:
+	SDL_SpinLock lock;
+	std::vector<CommandBuffer*> freeBuffers;
+	std::vector<CommandBuffer*> recordedBuffers;
+	std::vector<RenderCommand> merged;
+	Uint32 nextOrder;
+	Uint64 numFrames;
+	Uint64 numCommands;
+	Uint64 numStateChanges;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SDL.h>
+#include <functional>
+#include <vector>
+
+typedef std::function<void(SDL_Renderer* renderer, int width, int height)> WidgetPainter;
+
+struct UIWidget {
+	SDL_Rect rect;
+	WidgetPainter paint;
+	SDL_Texture* cache;
+	bool dirty;
+	bool visible;
+};
+
+// Keeps every widget's output in its own render-target texture and the whole UI
+// in one composite texture. Invalidating a widget repaints only its cache and
+// recomposites only the damaged regions, so a frame without changes costs one
+// copy of the composite. Falls back to painting directly when the renderer has
+// no render-target support.
+struct RetainedUI {
+public:
+	RetainedUI();
+	~RetainedUI();
+	bool init(SDL_Renderer* renderer, int width, int height, SDL_Color background);
+	int addWidget(SDL_Rect rect, WidgetPainter paint);
+	void setWidgetRect(int id, SDL_Rect rect);
+	void setWidgetVisible(int id, bool visible);
+	void invalidate(int id);
+	void invalidateAll();
+	void handleEvent(SDL_Event& event);
+	bool update();
+	void render(int x = 0, int y = 0);
+	void free();
+	int getNumRepainted();
+	int getNumComposited();
+
+private:
+	bool repaint(UIWidget& widget);
+	void addDamage(SDL_Rect rect);
+	void composite(const SDL_Rect& region);
+
+private:
+	SDL_Renderer* renderer;
+	SDL_Texture* compositeTexture;
+	int width;
+	int height;
+	SDL_Color background;
+	bool retained;
+	std::vector<UIWidget> widgets;
+	std::vector<SDL_Rect> damage;
+	int numRepainted;
+	int numComposited;
+};
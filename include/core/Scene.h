@@ -0,0 +1,92 @@
+#pragma once
+
+#include <core/MappedFile.h>
+#include <SDL.h>
+#include <string>
+
+enum SceneColliderShape {
+	SCENE_COLLIDER_RECT,
+	SCENE_COLLIDER_CIRCLE,
+};
+
+struct SceneHeader {
+	Uint32 magic;
+	Uint32 version;
+	Uint32 size;
+	Uint32 numTextures;
+	Uint32 numLayers;
+	Uint32 numEntities;
+	Uint32 numColliders;
+	Uint32 texturesOffset;
+	Uint32 layersOffset;
+	Uint32 entitiesOffset;
+	Uint32 collidersOffset;
+	Uint32 stringsOffset;
+};
+
+struct SceneTexture {
+	Uint32 nameOffset;
+	Uint32 pathOffset;
+};
+
+struct SceneLayer {
+	Uint32 nameOffset;
+	Sint32 depth;
+	Uint32 firstEntity;
+	Uint32 numEntities;
+};
+
+struct SceneCollider {
+	Uint32 shape;
+	SDL_Rect bounds;
+};
+
+struct SceneEntity {
+	Uint32 nameOffset;
+	Uint32 layer;
+	Sint32 texture;
+	Sint32 collider;
+	SDL_Rect rect;
+	SDL_Color color;
+};
+
+// Compiled scene as written by the scene_compile tool: a SceneHeader followed by
+// flat tables of textures, layers, entities (grouped by layer, in depth order)
+// and colliders, then a table of null-terminated strings. Every reference is an
+// offset or index, so the file is used in place straight from the mapping.
+// Only the header is checked on open; the getters return nullptr (or "" for
+// strings) when an index read from the file is out of range.
+struct Scene {
+public:
+	Scene();
+	bool open(std::string path);
+	void close();
+	Uint32 getNumTextures();
+	Uint32 getNumLayers();
+	Uint32 getNumEntities();
+	Uint32 getNumColliders();
+	const SceneTexture* getTexture(Uint32 index);
+	const SceneLayer* getLayer(Uint32 index);
+	const SceneEntity* getEntity(Uint32 index);
+	const SceneCollider* getCollider(Uint32 index);
+	const char* getString(Uint32 offset);
+	const SceneLayer* findLayer(std::string name);
+	const SceneEntity* findEntity(std::string name);
+
+public:
+	static constexpr Uint32 SCENE_MAGIC = SDL_FOURCC('S', 'D', 'L', 'C');
+	static constexpr Uint32 SCENE_VERSION = 1;
+
+private:
+	bool validate();
+
+private:
+	MappedFile file;
+	const Uint8* data;
+	const SceneHeader* header;
+	const SceneTexture* textures;
+	const SceneLayer* layers;
+	const SceneEntity* entities;
+	const SceneCollider* colliders;
+	const char* strings;
+};
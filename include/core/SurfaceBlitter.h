@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SDL.h>
+
+const char* const SURFACE_BLITTER_VARIABLE = "SDL_TEST_SURFACE_BLITTER";
+
+enum BlitPath {
+	BLIT_PATH_SDL,
+	BLIT_PATH_SCALAR,
+	BLIT_PATH_SSE2,
+	BLIT_PATH_AVX2,
+};
+
+typedef void (*ColorKeyRowFunction)(const Uint32* source, Uint32* destination, int count, Uint32 key, Uint32 rgbMask);
+typedef void (*BlendRowFunction)(const Uint32* source, Uint32* destination, int count, int alphaShift);
+typedef void (*NearestRowFunction)(const Uint32* source, Uint32* destination, const int* columns, int count);
+typedef void (*BilinearRowFunction)(const Uint32* top, const Uint32* bottom, Uint32* destination, const int* columns, const int* weights, int weightY, int count);
+
+// Software blitters for 32-bit surfaces sharing the same RGB layout: plain copy,
+// color-keyed copy, per-pixel alpha blend and nearest or bilinear scaling. The
+// row kernels are picked once at startup from the CPU features SDL reports
+// (AVX2, SSE2 or scalar). SDL_TEST_SURFACE_BLITTER set to "scalar", "sse2" or
+// "avx2" caps that choice, and "sdl" or 0 leaves every blit to SDL. Anything
+// the kernels do not cover, such as other depths, RLE surfaces or color and
+// alpha modulation, falls back to SDL_BlitSurface and SDL_BlitScaled. As with
+// SDL_BlitSurface, blit() stores the clipped area back in destinationRect.
+struct SurfaceBlitter {
+public:
+	static int blit(SDL_Surface* source, const SDL_Rect* sourceRect, SDL_Surface* destination, SDL_Rect* destinationRect);
+	static int blitScaled(SDL_Surface* source, const SDL_Rect* sourceRect, SDL_Surface* destination, SDL_Rect* destinationRect, bool smooth = false);
+	static BlitPath getPath();
+	static const char* getPathName();
+
+private:
+	enum Operation {
+		OPERATION_COPY,
+		OPERATION_COLOR_KEY,
+		OPERATION_BLEND,
+	};
+
+	static void selectPath();
+	static void setPath(BlitPath path);
+	static bool isCompatible(SDL_Surface* source, SDL_Surface* destination);
+	static bool hasModulation(SDL_Surface* source);
+	static bool blitRows(Operation operation, SDL_Surface* source, const SDL_Rect* sourceRect, SDL_Surface* destination, SDL_Rect* destinationRect);
+	static bool scale(bool smooth, SDL_Surface* source, const SDL_Rect* sourceRect, SDL_Surface* destination, const SDL_Rect* destinationRect);
+
+private:
+	static bool selected;
+	static BlitPath path;
+	static ColorKeyRowFunction colorKeyRow;
+	static BlendRowFunction blendRow;
+	static NearestRowFunction nearestRow;
+	static BilinearRowFunction bilinearRow;
+};
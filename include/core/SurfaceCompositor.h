@@ -0,0 +1,58 @@
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+
+// Records the blits and fills issued onto a window surface each frame and, on
+// present, compares them with the previous frame. Only the destination rects of
+// operations that changed (or whose source was invalidated) are redrawn and
+// pushed with SDL_UpdateWindowSurfaceRects; an unchanged frame pushes nothing.
+struct SurfaceCompositor {
+public:
+	SurfaceCompositor();
+	bool init(SDL_Window* window);
+	void blit(SDL_Surface* source, const SDL_Rect* sourceRect, const SDL_Rect* destinationRect);
+	void blitScaled(SDL_Surface* source, const SDL_Rect* sourceRect, const SDL_Rect* destinationRect);
+	void fill(const SDL_Rect* rect, Uint32 color);
+	void invalidate(const SDL_Rect* rect = nullptr);
+	void invalidateSurface(SDL_Surface* source);
+	void handleEvent(SDL_Event& event);
+	bool present();
+	SDL_Surface* getSurface();
+	Uint64 getBytesLastFrame();
+	Uint64 getTotalBytes();
+	Uint32 getNumFrames();
+	void printStatistics();
+
+private:
+	enum OperationType {
+		OPERATION_BLIT,
+		OPERATION_BLIT_SCALED,
+		OPERATION_FILL,
+	};
+
+	struct Operation {
+		OperationType type;
+		SDL_Surface* source;
+		SDL_Rect sourceRect;
+		SDL_Rect destinationRect;
+		Uint32 color;
+	};
+
+	void record(OperationType type, SDL_Surface* source, const SDL_Rect* sourceRect, const SDL_Rect* destinationRect, Uint32 color);
+	void execute(Operation& operation);
+	bool isChanged(const Operation& operation, const Operation* previous);
+	void addDamage(SDL_Rect rect);
+
+private:
+	SDL_Window* window;
+	SDL_Surface* screenSurface;
+	std::vector<Operation> operations;
+	std::vector<Operation> previousOperations;
+	std::vector<SDL_Surface*> changedSurfaces;
+	std::vector<SDL_Rect> damage;
+	bool pushAll;
+	Uint64 bytesLastFrame;
+	Uint64 totalBytes;
+	Uint32 numFrames;
+};
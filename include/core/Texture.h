@@ -10,6 +10,8 @@ public:
 	Texture();
 	~Texture();
 	bool loadFromFile(SDL_Renderer* renderer, std::string path);
+	bool loadFromSurface(SDL_Renderer* renderer, SDL_Surface* surface);
+	bool loadFromCooked(SDL_Renderer* renderer, SDL_RWops* file);
 	bool loadFromRenderedText(SDL_Renderer* renderer, TTF_Font* font, std::string textureText, SDL_Color textColor);
 	void setColor(Uint8 r, Uint8 g, Uint8 b);
 	void setBlendMode(SDL_BlendMode blendMode);
@@ -18,9 +20,16 @@ public:
 	void render(SDL_Renderer* renderer, int x, int y, SDL_Rect* clip = nullptr, double angle = 0.0, SDL_Point* center = nullptr, SDL_RendererFlip flip = SDL_FLIP_NONE);
 	int getWidth();
 	int getHeight();
+	static bool acceptsCooked(SDL_Renderer* renderer);
+
+private:
+	static SDL_RWops* openCooked(SDL_Renderer* renderer, std::string path);
 
 private:
 	SDL_Texture* texture;
+	SDL_Surface* surface;
+	SDL_Color colorMod;
+	SDL_BlendMode blendMode;
 	int width;
 	int height;
 };
\ No newline at end of file
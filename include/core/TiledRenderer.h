@@ -0,0 +1,89 @@
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+
+const char* const TILED_RENDERER_VARIABLE = "SDL_TEST_TILED_RENDERER";
+
+enum TiledCommandType {
+	TILED_COMMAND_FILL,
+	TILED_COMMAND_LINE,
+	TILED_COMMAND_COPY,
+};
+
+struct TiledCommand {
+	TiledCommandType type;
+	SDL_Rect bounds;
+	SDL_BlendMode blendMode;
+	SDL_Color color;
+	SDL_Surface* source;
+	SDL_Rect sourceRect;
+	SDL_Rect destinationRect;
+	SDL_Point from;
+	SDL_Point to;
+	double angle;
+	SDL_FPoint center;
+	SDL_RendererFlip flip;
+};
+
+// Multithreaded software backend for machines where SDL only has its
+// single-threaded software renderer. Texture::render and the static draw calls
+// below record commands instead of drawing; present() bins them into screen
+// tiles, rasterizes the tiles across the JobSystem workers into an ARGB8888
+// framebuffer and shows it through one streaming texture. The static calls
+// forward to SDL unchanged when no tiled renderer is bound to the renderer.
+struct TiledRenderer {
+public:
+	TiledRenderer();
+	~TiledRenderer();
+	bool init(SDL_Renderer* renderer, int width, int height);
+	void free();
+	void printStatistics();
+	int getNumThreads();
+	void copy(SDL_Surface* source, const SDL_Rect* sourceRect, const SDL_Rect* destinationRect, double angle, const SDL_Point* center, SDL_RendererFlip flip, SDL_Color colorMod, SDL_BlendMode blendMode);
+
+	static bool shouldEnable(SDL_Renderer* renderer);
+	static TiledRenderer* find(SDL_Renderer* renderer);
+	static int setDrawColor(SDL_Renderer* renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+	static int setDrawBlendMode(SDL_Renderer* renderer, SDL_BlendMode blendMode);
+	static int setViewport(SDL_Renderer* renderer, const SDL_Rect* rect);
+	static void getViewport(SDL_Renderer* renderer, SDL_Rect* rect);
+	static int setClipRect(SDL_Renderer* renderer, const SDL_Rect* rect);
+	static int clear(SDL_Renderer* renderer);
+	static int fillRect(SDL_Renderer* renderer, const SDL_Rect* rect);
+	static int drawRect(SDL_Renderer* renderer, const SDL_Rect* rect);
+	static int drawLine(SDL_Renderer* renderer, int x1, int y1, int x2, int y2);
+	static int drawPoint(SDL_Renderer* renderer, int x, int y);
+	static void present(SDL_Renderer* renderer);
+
+public:
+	static constexpr int TILE_SIZE = 64;
+
+private:
+	bool getClip(SDL_Rect* clip);
+	void record(TiledCommand& command);
+	void recordFill(const SDL_Rect& rect);
+	void rasterize();
+	void rasterizeTile(int tile);
+	void presentFrame();
+
+private:
+	SDL_Renderer* renderer;
+	SDL_Texture* streamingTexture;
+	int width;
+	int height;
+	int numTilesX;
+	int numTilesY;
+	std::vector<Uint32> framebuffer;
+	std::vector<TiledCommand> commands;
+	std::vector<std::vector<int>> tiles;
+	SDL_Color drawColor;
+	SDL_BlendMode drawBlendMode;
+	SDL_Rect viewport;
+	SDL_Rect clipRect;
+	bool clipEnabled;
+	Uint64 numFrames;
+	Uint64 rasterTicks;
+
+	static TiledRenderer* active;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <SDL.h>
+
+// Single-producer, single-consumer hand-off of whole T values. The writer
+// fills its back buffer and publishes it; the reader swaps in the newest
+// published one. Neither side ever waits for the other: the middle buffer is
+// exchanged atomically, and unread snapshots are simply replaced.
+template <typename T>
+struct TripleBuffer {
+public:
+	TripleBuffer() {
+		SDL_AtomicSet(&middle, 1);
+		back = 0;
+		front = 2;
+	}
+
+	// Writer side.
+	T& getWriteBuffer() {
+		return buffers[back];
+	}
+
+	void publish() {
+		back = SDL_AtomicSet(&middle, back | FRESH) & INDEX_MASK;
+	}
+
+	// Reader side. Returns true when a newer snapshot than the last one was
+	// picked up; getReadBuffer() stays valid until the next acquire().
+	bool acquire() {
+		if (!(SDL_AtomicGet(&middle) & FRESH)) {
+			return false;
+		}
+		front = SDL_AtomicSet(&middle, front) & INDEX_MASK;
+		return true;
+	}
+
+	const T& getReadBuffer() {
+		return buffers[front];
+	}
+
+private:
+	static constexpr int INDEX_MASK = 3;
+	static constexpr int FRESH = 4;
+
+	T buffers[3];
+	SDL_atomic_t middle;
+	int back;
+	int front;
+};
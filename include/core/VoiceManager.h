@@ -0,0 +1,65 @@
+#pragma once
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <vector>
+
+struct SoundEmitter {
+public:
+	Mix_Chunk* chunk = nullptr;
+	int posX = 0;
+	int posY = 0;
+	int priority = 0;
+	bool looping = false;
+	bool active = false;
+	bool alive = false;
+	int channel = -1;
+};
+
+// Owns every SDL_mixer channel and hands them out to positional emitters.
+// Only the loudest, highest-priority emitters in hearing range get a voice, so
+// the mixer never processes more than numVoices chunks however many emitters exist.
+struct VoiceManager {
+public:
+	VoiceManager();
+	bool init(int numVoices, int hearingDistance);
+	int createEmitter(Mix_Chunk* chunk, int priority, bool looping);
+	void destroyEmitter(int emitterId);
+	void setEmitterPosition(int emitterId, int x, int y);
+	void start(int emitterId);
+	void stop(int emitterId);
+	bool playAt(Mix_Chunk* chunk, int x, int y, int priority);
+	void setListenerPosition(int x, int y);
+	void update();
+	void free();
+	int getNumVoices();
+	int getNumPlaying();
+	int getNumCulled();
+	int getNumStolen();
+
+private:
+	struct Candidate {
+		int emitterId;
+		int priority;
+		int distanceSquared;
+	};
+
+	int distanceSquared(const SoundEmitter& emitter);
+	bool isAudible(int distanceSquared);
+	bool outranks(const Candidate& candidateA, const Candidate& candidateB);
+	int allocateEmitter();
+	int findVoice(const Candidate& candidate);
+	bool assignVoice(int emitterId, int channel);
+	void releaseVoice(int channel);
+	void positionVoice(int channel);
+
+private:
+	std::vector<SoundEmitter> emitters;
+	std::vector<int> freeEmitters;
+	std::vector<int> voices;
+	std::vector<Candidate> candidates;
+	int hearingDistance;
+	SDL_Point listener;
+	int numCulled;
+	int numStolen;
+};
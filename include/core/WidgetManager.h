@@ -0,0 +1,36 @@
+#pragma once
+
+#include <core/Button.h>
+#include <SDL.h>
+#include <vector>
+
+// Buckets buttons into a uniform grid of cells so a mouse event only tests the
+// buttons overlapping the cell under the cursor, and only the widget that gains
+// or loses the hover changes sprite. Later buttons are on top of earlier ones.
+struct WidgetManager {
+public:
+	WidgetManager();
+	void init(int width, int height, int cellSize = DEFAULT_CELL_SIZE);
+	void add(Button* button);
+	void rebuild();
+	void clear();
+	void handleEvent(SDL_Event& event);
+	Button* hitTest(int x, int y);
+	Button* getHovered();
+	int getNumWidgets();
+
+public:
+	static constexpr int DEFAULT_CELL_SIZE = 64;
+
+private:
+	void insert(int index);
+	int getCell(int x, int y);
+
+private:
+	std::vector<Button*> widgets;
+	std::vector<std::vector<int>> cells;
+	int columns;
+	int rows;
+	int cellSize;
+	Button* hovered;
+};
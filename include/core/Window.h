@@ -10,13 +10,17 @@ public:
 	Window();
 	bool init();
 	SDL_Renderer* createRenderer();
-	void handleEvent(SDL_Event& event, SDL_Renderer* renderer);
+	void handleEvent(SDL_Event& event);
 	void free();
 	int getWidth();
 	int getHeight();
 	bool hasMouseFocus();
 	bool hasKeyboardFocus();
 	bool isMinimized();
+	void invalidate();
+	bool needsRedraw();
+	void validate();
+	bool waitForEvent(Uint32 timeout);
 
 private:
 	SDL_Window* window;
@@ -28,12 +32,13 @@ private:
 	bool keyboardFocus;
 	bool fullScreen;
 	bool minimized;
+	bool dirty;
 };
 
 struct WindowEx {
 public:
 	WindowEx();
-	bool init();
+	bool init(bool vsync = true);
 	void handleEvent(SDL_Event& event);
 	void focus();
 	void render();
@@ -44,6 +49,12 @@ public:
 	bool hasKeyboardFocus();
 	bool isMinimized();
 	bool isShown();
+	bool isVisible();
+	bool hasVsync();
+	void invalidate();
+	bool needsRedraw();
+	int getRefreshRate();
+	Uint32 getWindowID();
 
 public:
 	static int numDisplays;
@@ -63,4 +74,6 @@ private:
 	bool fullScreen;
 	bool minimized;
 	bool shown;
+	bool vsync;
+	bool dirty;
 };
\ No newline at end of file
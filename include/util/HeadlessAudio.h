@@ -0,0 +1,18 @@
+#pragma once
+
+#include <SDL.h>
+#include <string>
+
+const char* const HEADLESS_AUDIO_VARIABLE = "SDL_TEST_HEADLESS_AUDIO";
+
+// Routes SDL audio to the "disk" driver (raw PCM written to a file) or, for an
+// empty path, to the "dummy" driver. Must be enabled before SDL_INIT_AUDIO.
+struct HeadlessAudio {
+public:
+	static bool enable(std::string outputPath, bool realTime = true);
+	static bool enableFromEnvironment();
+	static bool isEnabled();
+
+private:
+	static bool enabled;
+};
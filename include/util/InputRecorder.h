@@ -0,0 +1,59 @@
+#pragma once
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+struct InputRecordHeader {
+	Uint32 magic;
+	Uint32 version;
+	Uint32 numRecords;
+	Uint32 numFrames;
+};
+
+// Records keyboard, mouse, joystick and controller events against the frame they
+// arrived in, and replays them through SDL_PushEvent at the start of the same
+// frame while live input is filtered out. Each record is the frame number, the
+// event size and only the bytes of the SDL_Event member that type uses.
+// Selected on the command line with --record <file> or --replay <file>.
+struct InputRecorder {
+public:
+	static bool parseArguments(int argc, char** argv);
+	static bool startRecording(std::string path);
+	static bool startReplay(std::string path);
+	static void attach();
+	static void detach();
+	static void frame();
+	static bool isRecording();
+	static bool isReplaying();
+
+public:
+	static constexpr Uint32 INPUT_MAGIC = SDL_FOURCC('S', 'D', 'L', 'I');
+	static constexpr Uint32 INPUT_VERSION = 1;
+	static constexpr size_t MAX_RECORDS_SIZE = 64 * 1024 * 1024;
+
+private:
+	enum Mode {
+		MODE_NONE,
+		MODE_RECORDING,
+		MODE_REPLAYING,
+	};
+
+	static int SDLCALL filterEvent(void* userdata, SDL_Event* event);
+	static size_t getRecordedSize(Uint32 type);
+	static bool save();
+
+private:
+	static Mode mode;
+	static std::string path;
+	static std::vector<Uint8> records;
+	static Uint32 numRecords;
+	static Uint32 currentFrame;
+	static size_t replayOffset;
+	static bool replaying;
+	static bool attached;
+	static Uint64 attachedCounter;
+	static Uint32 attachedFrame;
+	static SDL_SpinLock recordLock;
+	static bool recordsFull;
+};
@@ -1,14 +1,19 @@
 #pragma once
 
+#include <core/TiledRenderer.h>
 #include <SDL.h>
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
 #include <string>
+#include <vector>
 
 const int WINDOW_WIDTH = 640;
 const int WINDOW_HEIGHT = 480;
 
+const char* const SIMULATION_THREAD_VARIABLE = "SDL_TEST_SIMULATION_THREAD";
+const char* const ON_DEMAND_RENDERING_VARIABLE = "SDL_TEST_ON_DEMAND_RENDERING";
+
 struct TestBase {
 public:
 	virtual bool init() = 0;
@@ -40,8 +45,52 @@ public:
 
 	virtual std::string name();
 
+	virtual bool supportsTiledRenderer();
+
+protected:
+	void enableTiledRenderer();
+
+	// Fixed-rate loop for scenes split into simulate() and renderSnapshot().
+	// Each step gets the input that arrived since the previous one. With
+	// SDL_TEST_SIMULATION_THREAD set, simulation runs on its own thread, so
+	// the scene must hand its state to renderSnapshot() through a
+	// TripleBuffer. Otherwise both sides run in turn on the main thread.
+	// The achieved step rate is reported when the loop ends.
+	void runSimulation(int stepsPerSecond);
+	virtual void simulate(std::vector<SDL_Event>& events);
+	virtual void renderSnapshot();
+
+	// On-demand rendering for scenes that change only on input. With
+	// SDL_TEST_ON_DEMAND_RENDERING set, waitForFrame() blocks in
+	// SDL_WaitEventTimeout until an event arrives and returns whether the
+	// frame needs drawing: after input, invalidate() or while animating.
+	// Otherwise, and while input is recorded or replayed, it returns true.
+	bool waitForFrame();
+	void invalidate();
+	void setAnimating(bool animating);
+
+private:
+	static int simulationThread(void* data);
+	void runSimulationSteps();
+	void step(std::vector<SDL_Event>& events);
+	void checkStepRate(int stepsPerSecond, Uint64 elapsedTicks);
+
 protected:
 	SDL_Renderer* renderer = nullptr;
+	TiledRenderer tiledRenderer;
+
+private:
+	static constexpr int MAX_STEPS_BEHIND = 5;
+	static constexpr double STEP_RATE_TOLERANCE = 0.05;
+	static constexpr Uint32 IDLE_TIMEOUT = 1000;
+
+	Uint64 stepTicks = 0;
+	Uint64 numSimulatedSteps = 0;
+	SDL_atomic_t simulationRunning;
+	SDL_SpinLock eventLock = 0;
+	std::vector<SDL_Event> pendingEvents;
+	bool redraw = true;
+	bool animating = false;
 };
 
 struct BasicTestBaseWithTTF : public BasicTestBase {
@@ -0,0 +1,309 @@
+#include <core/Animator.h>
+#include <core/AssetPack.h>
+#include <core/RenderQueue.h>
+#include <sstream>
+
+bool AnimationSet::load(std::string path) {
+	clear();
+	SDL_RWops* file = AssetPack::openFile(path);
+	if (!file) {
+		return false;
+	}
+	size_t size = 0;
+	char* data = static_cast<char*>(SDL_LoadFile_RW(file, &size, 1));
+	if (!data) {
+		return false;
+	}
+	std::istringstream stream(std::string(data, size));
+	SDL_free(data);
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(stream, line)) {
+		lineNumber++;
+		if (!parseLine(line, lineNumber)) {
+			clear();
+			return false;
+		}
+	}
+	if (clips.empty()) {
+		SDL_SetError("\"%s\" has no clips", path.c_str());
+		return false;
+	}
+	for (auto& clip : clips) {
+		if (clip.numFrames == 0) {
+			SDL_SetError("Clip \"%s\" has no frames", clip.name.c_str());
+			clear();
+			return false;
+		}
+		for (Uint32 i = 0; i < clip.numMarkers; i++) {
+			if (markers[clip.firstMarker + i].time > clip.length) {
+				SDL_SetError("Marker \"%s\" is past the end of clip \"%s\"", markers[clip.firstMarker + i].name.c_str(), clip.name.c_str());
+				clear();
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void AnimationSet::clear() {
+	clips.clear();
+	frames.clear();
+	markers.clear();
+}
+
+int AnimationSet::findClip(const std::string& name) {
+	for (size_t i = 0; i < clips.size(); i++) {
+		if (clips[i].name == name) {
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
+
+int AnimationSet::getNumClips() {
+	return static_cast<int>(clips.size());
+}
+
+const AnimationClip& AnimationSet::getClip(int clip) {
+	return clips[clip];
+}
+
+const AnimationFrame& AnimationSet::getFrame(int clip, int frame) {
+	return frames[clips[clip].firstFrame + frame];
+}
+
+const AnimationMarker& AnimationSet::getMarker(int clip, int marker) {
+	return markers[clips[clip].firstMarker + marker];
+}
+
+bool AnimationSet::parseLine(const std::string& line, int lineNumber) {
+	std::istringstream stream(line.substr(0, line.find('#')));
+	std::string keyword;
+	if (!(stream >> keyword)) {
+		return true;
+	}
+	if (keyword == "clip") {
+		std::string name, mode;
+		if (!(stream >> name >> mode) || (mode != "loop" && mode != "once") || findClip(name) >= 0) {
+			SDL_SetError("Line %d: bad or duplicate clip", lineNumber);
+			return false;
+		}
+		if (clips.size() > SDL_MAX_UINT16) {
+			SDL_SetError("Line %d: too many clips", lineNumber);
+			return false;
+		}
+		clips.push_back(AnimationClip{name, mode == "loop", 0, static_cast<Uint32>(frames.size()), 0, static_cast<Uint32>(markers.size()), 0});
+		return true;
+	}
+	if (clips.empty()) {
+		SDL_SetError("Line %d: \"%s\" before any clip", lineNumber, keyword.c_str());
+		return false;
+	}
+	AnimationClip& clip = clips.back();
+	if (keyword == "frame") {
+		AnimationFrame frame;
+		int milliseconds = 0;
+		if (!(stream >> frame.clip.x >> frame.clip.y >> frame.clip.w >> frame.clip.h >> milliseconds) || milliseconds <= 0 || clip.numFrames >= SDL_MAX_UINT16) {
+			SDL_SetError("Line %d: bad frame", lineNumber);
+			return false;
+		}
+		clip.length += milliseconds;
+		frame.end = clip.length;
+		frames.push_back(frame);
+		clip.numFrames++;
+	} else if (keyword == "marker") {
+		AnimationMarker marker;
+		int milliseconds = 0;
+		if (!(stream >> marker.name >> milliseconds) || milliseconds < 0) {
+			SDL_SetError("Line %d: bad marker", lineNumber);
+			return false;
+		}
+		marker.time = milliseconds;
+		markers.push_back(marker);
+		clip.numMarkers++;
+	} else {
+		SDL_SetError("Line %d: unknown declaration \"%s\"", lineNumber, keyword.c_str());
+		return false;
+	}
+	return true;
+}
+
+Animator::Animator() {
+	set = nullptr;
+}
+
+void Animator::init(AnimationSet* set) {
+	clear();
+	this->set = set;
+}
+
+AnimationInstance Animator::play(int clip, Texture* texture, int x, int y, float speed) {
+	AnimationInstance instance;
+	if (!freeInstances.empty()) {
+		instance = freeInstances.back();
+		freeInstances.pop_back();
+	} else {
+		instance = static_cast<AnimationInstance>(indices.size());
+		indices.push_back(-1);
+	}
+	indices[instance] = static_cast<int>(instances.size());
+	instances.push_back(instance);
+	clips.push_back(static_cast<Uint16>(clip));
+	frames.push_back(0);
+	times.push_back(0.0f);
+	speeds.push_back(speed);
+	finished.push_back(0);
+	posX.push_back(x);
+	posY.push_back(y);
+	textures.push_back(texture);
+	return instance;
+}
+
+void Animator::stop(AnimationInstance instance) {
+	if (!isPlaying(instance)) {
+		return;
+	}
+	int index = indices[instance];
+	int last = static_cast<int>(instances.size()) - 1;
+	clips[index] = clips[last];
+	frames[index] = frames[last];
+	times[index] = times[last];
+	speeds[index] = speeds[last];
+	finished[index] = finished[last];
+	posX[index] = posX[last];
+	posY[index] = posY[last];
+	textures[index] = textures[last];
+	instances[index] = instances[last];
+	indices[instances[index]] = index;
+	clips.pop_back();
+	frames.pop_back();
+	times.pop_back();
+	speeds.pop_back();
+	finished.pop_back();
+	posX.pop_back();
+	posY.pop_back();
+	textures.pop_back();
+	instances.pop_back();
+	indices[instance] = -1;
+	freeInstances.push_back(instance);
+}
+
+void Animator::clear() {
+	clips.clear();
+	frames.clear();
+	times.clear();
+	speeds.clear();
+	finished.clear();
+	posX.clear();
+	posY.clear();
+	textures.clear();
+	instances.clear();
+	indices.clear();
+	freeInstances.clear();
+	events.clear();
+}
+
+bool Animator::isPlaying(AnimationInstance instance) {
+	return instance < indices.size() && indices[instance] >= 0;
+}
+
+bool Animator::isFinished(AnimationInstance instance) {
+	return finished[indices[instance]] != 0;
+}
+
+int Animator::getNumInstances() {
+	return static_cast<int>(instances.size());
+}
+
+void Animator::setClip(AnimationInstance instance, int clip) {
+	int index = indices[instance];
+	clips[index] = static_cast<Uint16>(clip);
+	frames[index] = 0;
+	times[index] = 0.0f;
+	finished[index] = 0;
+}
+
+void Animator::setPosition(AnimationInstance instance, int x, int y) {
+	int index = indices[instance];
+	posX[index] = x;
+	posY[index] = y;
+}
+
+void Animator::setSpeed(AnimationInstance instance, float speed) {
+	speeds[indices[instance]] = speed;
+}
+
+const SDL_Rect& Animator::getFrameClip(AnimationInstance instance) {
+	int index = indices[instance];
+	return set->getFrame(clips[index], frames[index]).clip;
+}
+
+void Animator::update(Uint32 elapsedTicks) {
+	events.clear();
+	int numInstances = getNumInstances();
+	for (int i = 0; i < numInstances; i++) {
+		if (finished[i]) {
+			continue;
+		}
+		const AnimationClip& clip = set->getClip(clips[i]);
+		float length = static_cast<float>(clip.length);
+		float from = times[i];
+		float to = from + elapsedTicks * speeds[i];
+		if (to >= length) {
+			if (!clip.loop) {
+				fireMarkers(i, from, length, true);
+				times[i] = length;
+				frames[i] = static_cast<Uint16>(clip.numFrames - 1);
+				finished[i] = 1;
+				continue;
+			}
+			while (to >= length) {
+				fireMarkers(i, from, length, false);
+				from = 0.0f;
+				to -= length;
+			}
+			frames[i] = 0;
+		}
+		fireMarkers(i, from, to, false);
+		times[i] = to;
+		// Playback only moves forward, so the frame is found by stepping on
+		// from the current one.
+		Uint16 frame = frames[i];
+		while (frame + 1u < clip.numFrames && set->getFrame(clips[i], frame).end <= to) {
+			frame++;
+		}
+		frames[i] = frame;
+	}
+}
+
+const std::vector<AnimationEvent>& Animator::getEvents() {
+	return events;
+}
+
+void Animator::render(SDL_Renderer* renderer) {
+	int numInstances = getNumInstances();
+	for (int i = 0; i < numInstances; i++) {
+		SDL_Rect clip = set->getFrame(clips[i], frames[i]).clip;
+		textures[i]->render(renderer, posX[i], posY[i], &clip);
+	}
+}
+
+void Animator::record(RenderQueue& queue, Uint8 layer) {
+	queue.record(getNumInstances(), [this, layer](CommandBuffer& buffer, int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			buffer.drawSprite(layer, textures[i], posX[i], posY[i], &set->getFrame(clips[i], frames[i]).clip);
+		}
+	});
+}
+
+void Animator::fireMarkers(int index, float from, float to, bool inclusive) {
+	const AnimationClip& clip = set->getClip(clips[index]);
+	for (Uint32 i = 0; i < clip.numMarkers; i++) {
+		const AnimationMarker& marker = set->getMarker(clips[index], i);
+		float time = static_cast<float>(marker.time);
+		if (time >= from && (time < to || (inclusive && time == to))) {
+			events.push_back(AnimationEvent{instances[index], &marker.name});
+		}
+	}
+}
@@ -0,0 +1,633 @@
+#include <core/AssetLoader.h>
+#include <core/AssetPack.h>
+#include <core/CookedTexture.h>
+#include <core/Texture.h>
+#include <SDL_image.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifdef SDL_TEST_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#ifdef SDL_TEST_IO_URING
+
+struct IoUring {
+public:
+	static constexpr unsigned MAX_ENTRIES = 256;
+
+	bool init() {
+		io_uring_params params;
+		SDL_zero(params);
+		fd = static_cast<int>(syscall(__NR_io_uring_setup, MAX_ENTRIES, &params));
+		if (fd < 0) {
+			return false;
+		}
+		sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		if (params.features & IORING_FEAT_SINGLE_MMAP) {
+			sqRingSize = cqRingSize = SDL_max(sqRingSize, cqRingSize);
+		}
+		sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+		if (sqRing == MAP_FAILED) {
+			sqRing = nullptr;
+			free();
+			return false;
+		}
+		if (params.features & IORING_FEAT_SINGLE_MMAP) {
+			cqRing = sqRing;
+		} else {
+			cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+			if (cqRing == MAP_FAILED) {
+				cqRing = nullptr;
+				free();
+				return false;
+			}
+		}
+		sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		void* sqesAddress = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+		if (sqesAddress == MAP_FAILED) {
+			free();
+			return false;
+		}
+		sqes = static_cast<io_uring_sqe*>(sqesAddress);
+		Uint8* sq = static_cast<Uint8*>(sqRing);
+		sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+		sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+		sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+		sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+		Uint8* cq = static_cast<Uint8*>(cqRing);
+		cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+		cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+		cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+		cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+		entries = params.sq_entries;
+		if (!supportsRead()) {
+			free();
+			return false;
+		}
+		return true;
+	}
+
+	// Retained buffers are released only after a last drain and after the
+	// ring is closed, which cancels whatever reads are still outstanding.
+	void free() {
+		if (sqes && numCompleted != localTail) {
+			drain();
+		}
+		if (sqes) {
+			munmap(sqes, sqesSize);
+			sqes = nullptr;
+		}
+		if (cqRing && cqRing != sqRing) {
+			munmap(cqRing, cqRingSize);
+		}
+		cqRing = nullptr;
+		if (sqRing) {
+			munmap(sqRing, sqRingSize);
+			sqRing = nullptr;
+		}
+		if (fd >= 0) {
+			close(fd);
+			fd = -1;
+		}
+		retained.clear();
+	}
+
+	// Keeps a buffer that in-flight reads may still write into until free().
+	void retain(std::vector<Uint8>&& buffer) {
+		retained.push_back(std::move(buffer));
+	}
+
+	bool registerBuffer(void* data, size_t size) {
+		iovec buffer{data, size};
+		return syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, &buffer, 1) == 0;
+	}
+
+	void unregisterBuffer() {
+		syscall(__NR_io_uring_register, fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+	}
+
+	// Entries are only written here; the tail is published by submitAndWait().
+	void queueRead(int fileDescriptor, Uint8* destination, unsigned size, Uint64 offset, Uint64 userData, bool fixed) {
+		unsigned index = localTail & *sqMask;
+		io_uring_sqe* sqe = &sqes[index];
+		SDL_zerop(sqe);
+		sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+		sqe->fd = fileDescriptor;
+		sqe->addr = reinterpret_cast<Uint64>(destination);
+		sqe->len = size;
+		sqe->off = offset;
+		sqe->buf_index = 0;
+		sqe->user_data = userData;
+		sqArray[index] = index;
+		localTail++;
+	}
+
+	bool submitAndWait() {
+		__atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+		while (true) {
+			unsigned toSubmit = localTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+			int result = static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+			if (result >= 0) {
+				return true;
+			}
+			if (errno != EINTR) {
+				// The kernel only reads the ring inside io_uring_enter, so the
+				// entries it did not take can be withdrawn.
+				localTail = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+				__atomic_store_n(sqTail, localTail, __ATOMIC_RELEASE);
+				return false;
+			}
+		}
+	}
+
+	// Waits until every read handed to the kernel has completed, dropping the
+	// results, so nothing writes into the destinations afterwards.
+	bool drain() {
+		io_uring_cqe completion;
+		while (true) {
+			while (popCompletion(completion)) {
+			}
+			if (numCompleted == localTail) {
+				return true;
+			}
+			int result = static_cast<int>(syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+			if (result < 0 && errno != EINTR) {
+				return false;
+			}
+		}
+	}
+
+	bool popCompletion(io_uring_cqe& completion) {
+		unsigned head = *cqHead;
+		if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+			return false;
+		}
+		completion = cqes[head & *cqMask];
+		__atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+		numCompleted++;
+		return true;
+	}
+
+public:
+	unsigned entries = 0;
+
+private:
+	// IORING_OP_READ needs Linux 5.6; older kernels fail every read with -EINVAL.
+	bool supportsRead() {
+		std::vector<Uint8> storage(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op), 0);
+		io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+		if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 256) != 0) {
+			return false;
+		}
+		return probe->last_op >= IORING_OP_READ && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+	}
+
+private:
+	int fd = -1;
+	void* sqRing = nullptr;
+	void* cqRing = nullptr;
+	size_t sqRingSize = 0;
+	size_t cqRingSize = 0;
+	size_t sqesSize = 0;
+	io_uring_sqe* sqes = nullptr;
+	io_uring_cqe* cqes = nullptr;
+	unsigned* sqHead = nullptr;
+	unsigned* sqTail = nullptr;
+	unsigned* sqMask = nullptr;
+	unsigned* sqArray = nullptr;
+	unsigned* cqHead = nullptr;
+	unsigned* cqTail = nullptr;
+	unsigned* cqMask = nullptr;
+	unsigned localTail = 0;
+	unsigned numCompleted = 0;
+	std::vector<std::vector<Uint8>> retained;
+};
+
+#else
+
+struct IoUring {
+};
+
+#endif
+
+AssetLoader::AssetLoader() {
+	mutex = nullptr;
+	taskCondition = nullptr;
+	doneCondition = nullptr;
+	numUnfinished = 0;
+	quitting = false;
+	ring = nullptr;
+	currentBuffers = nullptr;
+	currentDecode = nullptr;
+	currentUserdata = nullptr;
+}
+
+AssetLoader::~AssetLoader() {
+	free();
+}
+
+bool AssetLoader::init(int numWorkers) {
+	if (numWorkers <= 0) {
+		numWorkers = SDL_max(SDL_GetCPUCount() - 1, 1);
+	}
+	mutex = SDL_CreateMutex();
+	taskCondition = SDL_CreateCond();
+	doneCondition = SDL_CreateCond();
+	if (!mutex || !taskCondition || !doneCondition) {
+		printf("Unable to create loader synchronization primitives! Error: %s\n", SDL_GetError());
+		return false;
+	}
+	quitting = false;
+	for (int i = 0; i < numWorkers; i++) {
+		SDL_Thread* worker = SDL_CreateThread(workerThread, "AssetLoader", this);
+		if (!worker) {
+			printf("Unable to create loader thread! Error: %s\n", SDL_GetError());
+			return false;
+		}
+		workers.push_back(worker);
+	}
+#ifdef SDL_TEST_IO_URING
+	ring = new IoUring();
+	if (!ring->init()) {
+		printf("Warning: io_uring is unavailable, reading assets on worker threads!\n");
+		delete ring;
+		ring = nullptr;
+	}
+#endif
+	return true;
+}
+
+bool AssetLoader::load(std::vector<AssetBuffer>& buffers, AssetDecodeFunction decode, void* userdata) {
+	currentBuffers = &buffers;
+	currentDecode = decode;
+	currentUserdata = userdata;
+
+	std::vector<int> pending;
+	std::vector<Uint8*> destinations(buffers.size(), nullptr);
+	size_t arenaSize = 0;
+	for (size_t i = 0; i < buffers.size(); i++) {
+		AssetBuffer& buffer = buffers[i];
+		buffer.loaded = false;
+		buffer.result = nullptr;
+		if (!locate(buffer)) {
+			printf("Unable to find asset \"%s\"!\n", buffer.path.c_str());
+			buffer.data = nullptr;
+			buffer.size = 0;
+			continue;
+		}
+		if (buffer.loaded) {
+			continue;
+		}
+		arenaSize += buffer.size;
+		pending.push_back(static_cast<int>(i));
+	}
+	arena.resize(arenaSize);
+	size_t offset = 0;
+	for (int index : pending) {
+		destinations[index] = arena.data() + offset;
+		buffers[index].data = destinations[index];
+		offset += buffers[index].size;
+	}
+
+	SDL_LockMutex(mutex);
+	numUnfinished = static_cast<int>(buffers.size());
+	SDL_UnlockMutex(mutex);
+	for (size_t i = 0; i < buffers.size(); i++) {
+		if (buffers[i].loaded || !buffers[i].data) {
+			push(static_cast<int>(i), nullptr);
+		}
+	}
+	if (!ring || !submitReads(pending, destinations)) {
+		for (int index : pending) {
+			push(index, destinations[index]);
+		}
+	}
+
+	SDL_LockMutex(mutex);
+	while (numUnfinished > 0) {
+		SDL_CondWait(doneCondition, mutex);
+	}
+	SDL_UnlockMutex(mutex);
+	currentBuffers = nullptr;
+
+	bool success = true;
+	for (const auto& buffer : buffers) {
+		success = success && buffer.loaded;
+	}
+	return success;
+}
+
+bool AssetLoader::loadSurfaces(const std::vector<std::string>& paths, std::vector<SDL_Surface*>& surfaces) {
+	std::vector<AssetBuffer> buffers(paths.size());
+	for (size_t i = 0; i < paths.size(); i++) {
+		buffers[i].path = paths[i];
+	}
+	bool success = load(buffers, [](const AssetBuffer& buffer, void*) -> void* {
+		return decodeSurface(buffer);
+	}, nullptr);
+	surfaces.clear();
+	for (const auto& buffer : buffers) {
+		SDL_Surface* surface = static_cast<SDL_Surface*>(buffer.result);
+		if (buffer.loaded && !surface) {
+			printf("Unable to decode image %s! Error: %s\n", buffer.path.c_str(), IMG_GetError());
+			success = false;
+		}
+		surfaces.push_back(surface);
+	}
+	return success;
+}
+
+bool AssetLoader::loadTextures(SDL_Renderer* renderer, const std::vector<std::string>& paths, const std::vector<Texture*>& textures) {
+	// Paths resolve to cooked textures exactly as in Texture::loadFromFile.
+	// The cooked file is tried first and the source is its fallback, so each
+	// texture is looked up by the batch only. Cooked files are uploaded here,
+	// since the renderer belongs to this thread; sources are decoded on the
+	// workers.
+	struct Batch {
+		std::vector<AssetBuffer> buffers;
+		std::vector<std::string> cookedPaths;
+	} batch;
+	batch.buffers.resize(paths.size());
+	batch.cookedPaths.resize(paths.size());
+	bool cookedAccepted = Texture::acceptsCooked(renderer);
+	for (size_t i = 0; i < paths.size(); i++) {
+		batch.buffers[i].path = paths[i];
+		if (cookedAccepted) {
+			batch.cookedPaths[i] = CookedTexture::getCookedPath(paths[i]);
+			batch.buffers[i].path = batch.cookedPaths[i];
+			batch.buffers[i].fallbackPath = paths[i];
+		}
+	}
+	load(batch.buffers, [](const AssetBuffer& buffer, void* userdata) -> void* {
+		Batch* batch = static_cast<Batch*>(userdata);
+		return buffer.path == batch->cookedPaths[&buffer - batch->buffers.data()] ? nullptr : decodeSurface(buffer);
+	}, &batch);
+	bool success = true;
+	for (size_t i = 0; i < paths.size(); i++) {
+		const AssetBuffer& buffer = batch.buffers[i];
+		bool loaded = false;
+		if (buffer.path == batch.cookedPaths[i]) {
+			loaded = buffer.loaded && textures[i]->loadFromCooked(renderer, SDL_RWFromConstMem(buffer.data, static_cast<int>(buffer.size)));
+			if (!loaded) {
+				printf("Warning: Unable to load cooked texture for %s! Error: %s\n", paths[i].c_str(), SDL_GetError());
+				loaded = textures[i]->loadFromFile(renderer, paths[i]);
+			}
+		} else {
+			SDL_Surface* surface = static_cast<SDL_Surface*>(buffer.result);
+			loaded = surface && textures[i]->loadFromSurface(renderer, surface);
+			SDL_FreeSurface(surface);
+		}
+		if (!loaded) {
+			printf("Unable to load texture %s! Error: %s\n", paths[i].c_str(), SDL_GetError());
+			success = false;
+		}
+	}
+	return success;
+}
+
+void AssetLoader::free() {
+	if (mutex) {
+		SDL_LockMutex(mutex);
+		quitting = true;
+		SDL_CondBroadcast(taskCondition);
+		SDL_UnlockMutex(mutex);
+	}
+	for (SDL_Thread* worker : workers) {
+		SDL_WaitThread(worker, nullptr);
+	}
+	workers.clear();
+#ifdef SDL_TEST_IO_URING
+	if (ring) {
+		ring->free();
+		delete ring;
+	}
+#endif
+	ring = nullptr;
+	if (doneCondition) {
+		SDL_DestroyCond(doneCondition);
+		doneCondition = nullptr;
+	}
+	if (taskCondition) {
+		SDL_DestroyCond(taskCondition);
+		taskCondition = nullptr;
+	}
+	if (mutex) {
+		SDL_DestroyMutex(mutex);
+		mutex = nullptr;
+	}
+	arena.clear();
+	arena.shrink_to_fit();
+}
+
+bool AssetLoader::isUsingIoUring() {
+	return ring != nullptr;
+}
+
+int AssetLoader::workerThread(void* data) {
+	AssetLoader* loader = static_cast<AssetLoader*>(data);
+	while (true) {
+		SDL_LockMutex(loader->mutex);
+		while (loader->tasks.empty() && !loader->quitting) {
+			SDL_CondWait(loader->taskCondition, loader->mutex);
+		}
+		if (loader->tasks.empty()) {
+			SDL_UnlockMutex(loader->mutex);
+			break;
+		}
+		Task task = loader->tasks.front();
+		loader->tasks.pop_front();
+		SDL_UnlockMutex(loader->mutex);
+
+		AssetBuffer& buffer = (*loader->currentBuffers)[task.index];
+		if (task.destination) {
+			buffer.loaded = readFile(buffer, task.destination);
+		}
+		if (buffer.loaded) {
+			buffer.result = loader->currentDecode(buffer, loader->currentUserdata);
+		}
+
+		SDL_LockMutex(loader->mutex);
+		loader->numUnfinished--;
+		if (loader->numUnfinished == 0) {
+			SDL_CondSignal(loader->doneCondition);
+		}
+		SDL_UnlockMutex(loader->mutex);
+	}
+	return 0;
+}
+
+SDL_Surface* AssetLoader::decodeSurface(const AssetBuffer& buffer) {
+	SDL_Surface* surface = IMG_Load_RW(SDL_RWFromConstMem(buffer.data, static_cast<int>(buffer.size)), 1);
+	if (surface) {
+		SDL_SetColorKey(surface, true, SDL_MapRGB(surface->format, 0x00, 0xFF, 0xFF));
+	}
+	return surface;
+}
+
+bool AssetLoader::locate(AssetBuffer& buffer) {
+	if (AssetPack::findMounted(buffer.path, &buffer.data, &buffer.size)) {
+		buffer.loaded = true;
+		return true;
+	}
+	struct stat fileStat;
+	if (stat(buffer.path.c_str(), &fileStat) == 0) {
+		buffer.size = static_cast<size_t>(fileStat.st_size);
+		return true;
+	}
+	if (buffer.fallbackPath.empty()) {
+		return false;
+	}
+	buffer.path.swap(buffer.fallbackPath);
+	buffer.fallbackPath.clear();
+	return locate(buffer);
+}
+
+bool AssetLoader::readFile(AssetBuffer& buffer, Uint8* destination) {
+	SDL_RWops* file = SDL_RWFromFile(buffer.path.c_str(), "rb");
+	if (!file) {
+		printf("Unable to open asset \"%s\"! Error: %s\n", buffer.path.c_str(), SDL_GetError());
+		return false;
+	}
+	bool success = buffer.size == 0 || SDL_RWread(file, destination, buffer.size, 1) == 1;
+	SDL_RWclose(file);
+	return success;
+}
+
+void AssetLoader::push(int index, Uint8* destination) {
+	SDL_LockMutex(mutex);
+	tasks.push_back(Task{index, destination});
+	SDL_CondSignal(taskCondition);
+	SDL_UnlockMutex(mutex);
+}
+
+bool AssetLoader::submitReads(std::vector<int>& pending, std::vector<Uint8*>& destinations) {
+#ifdef SDL_TEST_IO_URING
+	std::vector<AssetBuffer>& buffers = *currentBuffers;
+	std::vector<int> fileDescriptors(buffers.size(), -1);
+	std::vector<size_t> completed(buffers.size(), 0);
+	bool fixed = !arena.empty() && ring->registerBuffer(arena.data(), arena.size());
+	size_t next = 0;
+	size_t numRemaining = pending.size();
+	unsigned numInFlight = 0;
+	bool success = true;
+	std::vector<int> resubmit;
+
+	auto queue = [&](int index) {
+		size_t done = completed[index];
+		size_t size = SDL_min(buffers[index].size - done, static_cast<size_t>(1) << 30);
+		ring->queueRead(fileDescriptors[index], destinations[index] + done, static_cast<unsigned>(size), done, static_cast<Uint64>(index), fixed);
+		numInFlight++;
+	};
+	auto finish = [&](int index, bool loaded) {
+		close(fileDescriptors[index]);
+		fileDescriptors[index] = -1;
+		buffers[index].loaded = loaded;
+		push(index, nullptr);
+		numRemaining--;
+	};
+
+	while (success && numRemaining > 0) {
+		while (!resubmit.empty() && numInFlight < ring->entries) {
+			queue(resubmit.back());
+			resubmit.pop_back();
+		}
+		while (next < pending.size() && numInFlight < ring->entries) {
+			int index = pending[next++];
+			fileDescriptors[index] = open(buffers[index].path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fileDescriptors[index] < 0) {
+				printf("Unable to open asset \"%s\"!\n", buffers[index].path.c_str());
+				buffers[index].loaded = false;
+				push(index, nullptr);
+				numRemaining--;
+			} else if (buffers[index].size == 0) {
+				finish(index, true);
+			} else {
+				queue(index);
+			}
+		}
+		if (numInFlight == 0) {
+			continue;
+		}
+		if (!ring->submitAndWait()) {
+			success = false;
+			break;
+		}
+		io_uring_cqe completion;
+		while (ring->popCompletion(completion)) {
+			int index = static_cast<int>(completion.user_data);
+			numInFlight--;
+			if (completion.res == -EINVAL) {
+				// The kernel refused the operation itself, the worker reads it instead.
+				close(fileDescriptors[index]);
+				fileDescriptors[index] = -1;
+				push(index, destinations[index]);
+				numRemaining--;
+			} else if (completion.res <= 0) {
+				printf("Unable to read asset \"%s\"! Error: %s\n", buffers[index].path.c_str(), strerror(-completion.res));
+				finish(index, false);
+			} else {
+				completed[index] += completion.res;
+				if (completed[index] < buffers[index].size) {
+					resubmit.push_back(index);
+				} else {
+					finish(index, true);
+				}
+			}
+		}
+	}
+
+	bool drained = success || ring->drain();
+	if (fixed) {
+		ring->unregisterBuffer();
+	}
+	if (!drained) {
+		// Reads may still land in the arena, so the ring keeps it until it is
+		// torn down, and the remaining assets fail.
+		printf("Warning: io_uring could not be drained, disabling it!\n");
+		for (int index : pending) {
+			if (fileDescriptors[index] >= 0) {
+				close(fileDescriptors[index]);
+				buffers[index].loaded = false;
+				push(index, nullptr);
+			}
+		}
+		for (size_t i = next; i < pending.size(); i++) {
+			buffers[pending[i]].loaded = false;
+			push(pending[i], nullptr);
+		}
+		ring->retain(std::move(arena));
+		arena.clear();
+		ring->free();
+		delete ring;
+		ring = nullptr;
+		return true;
+	}
+	if (!success) {
+		printf("Warning: io_uring submission failed, reading remaining assets on worker threads!\n");
+		std::vector<int> remaining;
+		for (int index : pending) {
+			if (fileDescriptors[index] >= 0) {
+				close(fileDescriptors[index]);
+				remaining.push_back(index);
+			}
+		}
+		for (size_t i = next; i < pending.size(); i++) {
+			remaining.push_back(pending[i]);
+		}
+		pending.swap(remaining);
+	}
+	return success;
+#else
+	static_cast<void>(pending);
+	static_cast<void>(destinations);
+	return false;
+#endif
+}
@@ -0,0 +1,134 @@
+#include <core/AssetPack.h>
+#include <stdio.h>
+
+AssetPack* AssetPack::mounted = nullptr;
+
+AssetPack::AssetPack() {
+	header = nullptr;
+	entries = nullptr;
+	names = nullptr;
+}
+
+bool AssetPack::open(std::string path) {
+	close();
+	if (!file.open(path, false)) {
+		return false;
+	}
+	const Uint8* data = file.getData();
+	Uint64 size = file.getSize();
+	const PackHeader* packHeader = reinterpret_cast<const PackHeader*>(data);
+	if (size < sizeof(PackHeader) || packHeader->magic != PACK_MAGIC || packHeader->version != PACK_VERSION) {
+		SDL_SetError("\"%s\" is not an asset pack", path.c_str());
+		file.close();
+		return false;
+	}
+	if (sizeof(PackHeader) + packHeader->numEntries * sizeof(PackEntry) > packHeader->namesOffset || packHeader->namesOffset > packHeader->dataOffset || packHeader->dataOffset > size) {
+		SDL_SetError("Asset pack \"%s\" is truncated", path.c_str());
+		file.close();
+		return false;
+	}
+	// Every entry must lie inside the mapping, so lookups never read past it.
+	const PackEntry* packEntries = reinterpret_cast<const PackEntry*>(data + sizeof(PackHeader));
+	Uint64 namesSize = packHeader->dataOffset - packHeader->namesOffset;
+	for (Uint32 i = 0; i < packHeader->numEntries; i++) {
+		const PackEntry& entry = packEntries[i];
+		bool dataValid = entry.offset <= size && entry.size <= size - entry.offset && entry.size <= static_cast<Uint64>(SDL_MAX_SINT32);
+		bool nameValid = entry.nameOffset <= namesSize && entry.nameLength <= namesSize - entry.nameOffset;
+		if (!dataValid || !nameValid) {
+			SDL_SetError("Asset pack \"%s\" has a corrupt entry %u", path.c_str(), i);
+			file.close();
+			return false;
+		}
+	}
+	file.prefetch();
+	header = packHeader;
+	entries = packEntries;
+	names = reinterpret_cast<const char*>(data + header->namesOffset);
+	return true;
+}
+
+void AssetPack::close() {
+	file.close();
+	header = nullptr;
+	entries = nullptr;
+	names = nullptr;
+}
+
+bool AssetPack::contains(std::string name) {
+	return find(name) != nullptr;
+}
+
+SDL_RWops* AssetPack::openAsset(std::string name) {
+	const PackEntry* entry = find(name);
+	if (!entry) {
+		SDL_SetError("Asset \"%s\" is not in the pack", name.c_str());
+		return nullptr;
+	}
+	return SDL_RWFromConstMem(file.getData() + entry->offset, static_cast<int>(entry->size));
+}
+
+bool AssetPack::mount(std::string path) {
+	unmount();
+	AssetPack* pack = new AssetPack();
+	if (!pack->open(path)) {
+		delete pack;
+		return false;
+	}
+	printf("Mounted asset pack \"%s\" with %u assets!\n", path.c_str(), pack->header->numEntries);
+	mounted = pack;
+	return true;
+}
+
+void AssetPack::unmount() {
+	delete mounted;
+	mounted = nullptr;
+}
+
+SDL_RWops* AssetPack::openFile(std::string path) {
+	if (mounted && mounted->contains(path)) {
+		return mounted->openAsset(path);
+	}
+	return SDL_RWFromFile(path.c_str(), "rb");
+}
+
+bool AssetPack::findMounted(std::string path, const Uint8** data, size_t* size) {
+	const PackEntry* entry = mounted ? mounted->find(path) : nullptr;
+	if (!entry) {
+		return false;
+	}
+	*data = mounted->file.getData() + entry->offset;
+	*size = static_cast<size_t>(entry->size);
+	return true;
+}
+
+Uint64 AssetPack::hash(const std::string& name) {
+	Uint64 value = 14695981039346656037ULL;
+	for (char c : name) {
+		value ^= static_cast<Uint8>(c);
+		value *= 1099511628211ULL;
+	}
+	return value;
+}
+
+const PackEntry* AssetPack::find(const std::string& name) {
+	if (!header) {
+		return nullptr;
+	}
+	Uint64 value = hash(name);
+	Uint32 low = 0;
+	Uint32 high = header->numEntries;
+	while (low < high) {
+		Uint32 middle = low + (high - low) / 2;
+		if (entries[middle].hash < value) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	for (Uint32 i = low; i < header->numEntries && entries[i].hash == value; i++) {
+		if (entries[i].nameLength == name.size() && name.compare(0, name.size(), names + entries[i].nameOffset, entries[i].nameLength) == 0) {
+			return &entries[i];
+		}
+	}
+	return nullptr;
+}
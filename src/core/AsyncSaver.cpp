@@ -0,0 +1,225 @@
+#include <core/AsyncSaver.h>
+#include <array>
+#include <stdio.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <libgen.h>
+#endif
+
+AsyncSaver::AsyncSaver() {
+	worker = nullptr;
+	mutex = nullptr;
+	condition = nullptr;
+	pending = false;
+	quitting = false;
+	SDL_AtomicSet(&numSaved, 0);
+	SDL_AtomicSet(&numFailed, 0);
+}
+
+AsyncSaver::~AsyncSaver() {
+	free();
+}
+
+bool AsyncSaver::init() {
+	mutex = SDL_CreateMutex();
+	condition = SDL_CreateCond();
+	if (!mutex || !condition) {
+		printf("Unable to create saver synchronization primitives! Error: %s\n", SDL_GetError());
+		return false;
+	}
+	quitting = false;
+	worker = SDL_CreateThread(workerThread, "AsyncSaver", this);
+	if (!worker) {
+		printf("Unable to create saver thread! Error: %s\n", SDL_GetError());
+		return false;
+	}
+	return true;
+}
+
+bool AsyncSaver::save(std::string path, Uint32 version, const void* data, size_t size) {
+	if (!worker) {
+		return false;
+	}
+	SaveHeader header;
+	header.magic = SAVE_MAGIC;
+	header.version = version;
+	header.payloadSize = size;
+	header.checksum = 0;
+	header.reserved = 0;
+	SDL_LockMutex(mutex);
+	pendingPath = path;
+	pendingBuffer.resize(sizeof(SaveHeader) + size);
+	SDL_memcpy(pendingBuffer.data(), &header, sizeof(SaveHeader));
+	if (size > 0) {
+		SDL_memcpy(pendingBuffer.data() + sizeof(SaveHeader), data, size);
+	}
+	pending = true;
+	SDL_CondSignal(condition);
+	SDL_UnlockMutex(mutex);
+	return true;
+}
+
+void AsyncSaver::free() {
+	if (worker) {
+		SDL_LockMutex(mutex);
+		quitting = true;
+		SDL_CondSignal(condition);
+		SDL_UnlockMutex(mutex);
+		SDL_WaitThread(worker, nullptr);
+		worker = nullptr;
+	}
+	if (condition) {
+		SDL_DestroyCond(condition);
+		condition = nullptr;
+	}
+	if (mutex) {
+		SDL_DestroyMutex(mutex);
+		mutex = nullptr;
+	}
+}
+
+int AsyncSaver::getNumSaved() {
+	return SDL_AtomicGet(&numSaved);
+}
+
+int AsyncSaver::getNumFailed() {
+	return SDL_AtomicGet(&numFailed);
+}
+
+bool AsyncSaver::load(std::string path, Uint32 version, std::vector<Uint8>& payload) {
+	SDL_RWops* file = SDL_RWFromFile(path.c_str(), "rb");
+	if (!file) {
+		return false;
+	}
+	bool success = false;
+	SaveHeader header;
+	if (SDL_RWread(file, &header, sizeof(SaveHeader), 1) != 1) {
+		SDL_SetError("Save file \"%s\" is truncated", path.c_str());
+	} else if (header.magic != SAVE_MAGIC || header.version != version) {
+		SDL_SetError("Save file \"%s\" has an unknown format or version", path.c_str());
+	} else if (static_cast<Uint64>(SDL_RWsize(file)) != sizeof(SaveHeader) + header.payloadSize) {
+		SDL_SetError("Save file \"%s\" has the wrong size", path.c_str());
+	} else {
+		payload.resize(static_cast<size_t>(header.payloadSize));
+		if (header.payloadSize > 0 && SDL_RWread(file, payload.data(), payload.size(), 1) != 1) {
+			SDL_SetError("Unable to read save file \"%s\"", path.c_str());
+		} else if (checksum(payload.data(), payload.size()) != header.checksum) {
+			SDL_SetError("Save file \"%s\" is corrupted", path.c_str());
+		} else {
+			success = true;
+		}
+	}
+	SDL_RWclose(file);
+	return success;
+}
+
+Uint32 AsyncSaver::checksum(const Uint8* data, size_t size) {
+	static const auto table = [] {
+		std::array<Uint32, 256> table;
+		for (Uint32 i = 0; i < 256; i++) {
+			Uint32 value = i;
+			for (int j = 0; j < 8; j++) {
+				value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+			}
+			table[i] = value;
+		}
+		return table;
+	}();
+	Uint32 crc = 0xFFFFFFFF;
+	for (size_t i = 0; i < size; i++) {
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	}
+	return crc ^ 0xFFFFFFFF;
+}
+
+int AsyncSaver::workerThread(void* data) {
+	AsyncSaver* saver = static_cast<AsyncSaver*>(data);
+	while (true) {
+		SDL_LockMutex(saver->mutex);
+		while (!saver->pending && !saver->quitting) {
+			SDL_CondWait(saver->condition, saver->mutex);
+		}
+		if (!saver->pending) {
+			SDL_UnlockMutex(saver->mutex);
+			break;
+		}
+		std::string path = saver->pendingPath;
+		saver->writingBuffer.swap(saver->pendingBuffer);
+		saver->pending = false;
+		SDL_UnlockMutex(saver->mutex);
+		SaveHeader* header = reinterpret_cast<SaveHeader*>(saver->writingBuffer.data());
+		header->checksum = checksum(saver->writingBuffer.data() + sizeof(SaveHeader), saver->writingBuffer.size() - sizeof(SaveHeader));
+		if (writeAtomically(path, saver->writingBuffer)) {
+			SDL_AtomicAdd(&saver->numSaved, 1);
+		} else {
+			printf("Unable to save file \"%s\"! Error: %s\n", path.c_str(), SDL_GetError());
+			SDL_AtomicAdd(&saver->numFailed, 1);
+		}
+	}
+	return 0;
+}
+
+bool AsyncSaver::writeAtomically(const std::string& path, const std::vector<Uint8>& buffer) {
+	std::string tempPath = path + ".tmp";
+#ifdef _WIN32
+	HANDLE file = CreateFileA(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		SDL_SetError("Unable to create \"%s\"", tempPath.c_str());
+		return false;
+	}
+	DWORD written = 0;
+	bool success = WriteFile(file, buffer.data(), static_cast<DWORD>(buffer.size()), &written, nullptr) && written == buffer.size();
+	success = success && FlushFileBuffers(file);
+	CloseHandle(file);
+	if (!success) {
+		SDL_SetError("Unable to write \"%s\"", tempPath.c_str());
+		DeleteFileA(tempPath.c_str());
+		return false;
+	}
+	if (!MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+		SDL_SetError("Unable to replace \"%s\"", path.c_str());
+		return false;
+	}
+#else
+	int file = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (file < 0) {
+		SDL_SetError("Unable to create \"%s\"", tempPath.c_str());
+		return false;
+	}
+	size_t offset = 0;
+	while (offset < buffer.size()) {
+		ssize_t written = ::write(file, buffer.data() + offset, buffer.size() - offset);
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (written <= 0) {
+			break;
+		}
+		offset += written;
+	}
+	bool success = offset == buffer.size() && fsync(file) == 0;
+	::close(file);
+	if (!success) {
+		SDL_SetError("Unable to write \"%s\"", tempPath.c_str());
+		unlink(tempPath.c_str());
+		return false;
+	}
+	if (rename(tempPath.c_str(), path.c_str()) != 0) {
+		SDL_SetError("Unable to replace \"%s\"", path.c_str());
+		return false;
+	}
+	std::vector<char> directoryPath(path.begin(), path.end());
+	directoryPath.push_back('\0');
+	int directory = ::open(dirname(directoryPath.data()), O_RDONLY);
+	if (directory >= 0) {
+		fsync(directory);
+		::close(directory);
+	}
+#endif
+	return true;
+}
@@ -21,17 +21,14 @@ void Button::setPosition(int x, int y) {
 void Button::handleEvent(SDL_Event* e) {
 	if (e->type == SDL_MOUSEMOTION || e->type == SDL_MOUSEBUTTONDOWN || e->type == SDL_MOUSEBUTTONUP) {
 		int x, y;
-		SDL_GetMouseState(&x, &y);
-		bool inside = true;
-		if (x < position.x) {
-			inside = false;
-		} else if (x > position.x + width) {
-			inside = false;
-		} else if (y < position.y) {
-			inside = false;
-		} else if (y > position.y + height) {
-			inside = false;
+		if (e->type == SDL_MOUSEMOTION) {
+			x = e->motion.x;
+			y = e->motion.y;
+		} else {
+			x = e->button.x;
+			y = e->button.y;
 		}
+		bool inside = contains(x, y);
 		if (!inside) {
 			currentSprite = BUTTON_SPRITE_MOUSE_OUT;
 		} else {
@@ -56,6 +53,22 @@ void Button::handleEvent(SDL_Event* e) {
 	}
 }
 
+bool Button::contains(int x, int y) {
+	return x >= position.x && x <= position.x + width && y >= position.y && y <= position.y + height;
+}
+
+SDL_Rect Button::getRect() {
+	return SDL_Rect{position.x, position.y, width, height};
+}
+
+void Button::setSprite(ButtonSprite sprite) {
+	currentSprite = sprite;
+}
+
+ButtonSprite Button::getSprite() {
+	return currentSprite;
+}
+
 void Button::render(SDL_Renderer* renderer, Texture* buttonSpriteSheetTexture, SDL_Rect* buttonClips) {
 	buttonSpriteSheetTexture->render(renderer, position.x, position.y, &buttonClips[currentSprite]);
 }
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include <core/CookedTexture.h>
+#include <stdio.h>
+#include <vector>
+
+namespace {
+
+void encodeRuns(const SDL_Surface* surface, std::vector<Uint32>& runs) {
+	for (int y = 0; y < surface->h; y++) {
+		const Uint32* row = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(surface->pixels) + y * surface->pitch);
+		int x = 0;
+		while (x < surface->w) {
+			Uint32 pixel = row[x];
+			Uint32 count = 1;
+			while (x + count < static_cast<Uint32>(surface->w) && row[x + count] == pixel) {
+				count++;
+			}
+			runs.push_back(count);
+			runs.push_back(pixel);
+			x += count;
+		}
+	}
+}
+
+bool decodeRuns(const Uint32* runs, size_t numRuns, Uint32* pixels, size_t numPixels) {
+	size_t position = 0;
+	for (size_t i = 0; i + 1 < numRuns; i += 2) {
+		Uint32 count = runs[i];
+		Uint32 pixel = runs[i + 1];
+		if (position + count > numPixels) {
+			return false;
+		}
+		for (Uint32 j = 0; j < count; j++) {
+			pixels[position++] = pixel;
+		}
+	}
+	return position == numPixels;
+}
+
+}
+
+std::string CookedTexture::getCookedPath(std::string path) {
+	// The source extension stays in the name, so "foo.png" and "foo.bmp" do
+	// not cook to the same file.
+	return path + ".tex";
+}
+
+SDL_Surface* CookedTexture::bake(SDL_Surface* surface, Uint32 format) {
+	if (SDL_BYTESPERPIXEL(format) != 4 || !SDL_ISPIXELFORMAT_ALPHA(format)) {
+		SDL_SetError("Cooked textures must use a 32-bit format with alpha");
+		return nullptr;
+	}
+	SDL_Surface* baked = SDL_ConvertSurfaceFormat(surface, format, 0);
+	if (!baked) {
+		return nullptr;
+	}
+	const SDL_PixelFormat* pixelFormat = baked->format;
+	Uint32 rgbMask = pixelFormat->Rmask | pixelFormat->Gmask | pixelFormat->Bmask;
+	Uint32 colorKey = SDL_MapRGB(pixelFormat, 0x00, 0xFF, 0xFF) & rgbMask;
+	for (int y = 0; y < baked->h; y++) {
+		Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(baked->pixels) + y * baked->pitch);
+		for (int x = 0; x < baked->w; x++) {
+			if ((row[x] & rgbMask) == colorKey) {
+				row[x] &= ~pixelFormat->Amask;
+			}
+		}
+	}
+	return baked;
+}
+
+bool CookedTexture::save(SDL_Surface* surface, std::string path, bool compress) {
+	CookedTextureHeader header;
+	header.magic = COOKED_MAGIC;
+	header.version = COOKED_VERSION;
+	header.format = surface->format->format;
+	header.compression = COOKED_COMPRESSION_NONE;
+	header.width = surface->w;
+	header.height = surface->h;
+	header.pitch = surface->w * 4;
+	header.dataSize = header.pitch * header.height;
+
+	std::vector<Uint32> runs;
+	if (compress) {
+		encodeRuns(surface, runs);
+		if (runs.size() * sizeof(Uint32) < header.dataSize) {
+			header.compression = COOKED_COMPRESSION_RLE;
+			header.dataSize = static_cast<Uint32>(runs.size() * sizeof(Uint32));
+		}
+	}
+
+	SDL_RWops* file = SDL_RWFromFile(path.c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	bool success = SDL_RWwrite(file, &header, sizeof(CookedTextureHeader), 1) == 1;
+	if (header.compression == COOKED_COMPRESSION_RLE) {
+		success = success && SDL_RWwrite(file, runs.data(), header.dataSize, 1) == 1;
+	} else {
+		for (int y = 0; y < surface->h && success; y++) {
+			success = SDL_RWwrite(file, static_cast<Uint8*>(surface->pixels) + y * surface->pitch, header.pitch, 1) == 1;
+		}
+	}
+	SDL_RWclose(file);
+	return success;
+}
+
+SDL_Texture* CookedTexture::load(SDL_Renderer* renderer, SDL_RWops* file, int* width, int* height) {
+	CookedTextureHeader header;
+	if (SDL_RWread(file, &header, sizeof(CookedTextureHeader), 1) != 1 || header.magic != COOKED_MAGIC || header.version != COOKED_VERSION) {
+		SDL_SetError("Not a cooked texture");
+		SDL_RWclose(file);
+		return nullptr;
+	}
+
+	if (SDL_BYTESPERPIXEL(header.format) != 4 || header.width <= 0 || header.height <= 0 || header.width > SDL_MAX_SINT32 / 4) {
+		SDL_SetError("Cooked texture has an unsupported format or size");
+		SDL_RWclose(file);
+		return nullptr;
+	}
+	int pitch = header.pitch;
+	if (header.compression == COOKED_COMPRESSION_RLE) {
+		pitch = header.width * 4;
+	} else if (header.compression != COOKED_COMPRESSION_NONE || pitch < header.width * 4 || static_cast<Uint64>(pitch) * header.height > header.dataSize) {
+		SDL_SetError("Cooked texture pixels do not fit the payload");
+		SDL_RWclose(file);
+		return nullptr;
+	}
+
+	const Uint8* data = nullptr;
+	std::vector<Uint8> buffer;
+	if (file->type == SDL_RWOPS_MEMORY_RO && file->hidden.mem.stop - file->hidden.mem.here >= header.dataSize) {
+		data = file->hidden.mem.here;
+	} else {
+		buffer.resize(header.dataSize);
+		if (SDL_RWread(file, buffer.data(), header.dataSize, 1) != 1) {
+			SDL_SetError("Cooked texture is truncated");
+			SDL_RWclose(file);
+			return nullptr;
+		}
+		data = buffer.data();
+	}
+
+	std::vector<Uint32> pixels;
+	if (header.compression == COOKED_COMPRESSION_RLE) {
+		pixels.resize(static_cast<size_t>(header.width) * header.height);
+		if (!decodeRuns(reinterpret_cast<const Uint32*>(data), header.dataSize / sizeof(Uint32), pixels.data(), pixels.size())) {
+			SDL_SetError("Cooked texture is corrupted");
+			SDL_RWclose(file);
+			return nullptr;
+		}
+		data = reinterpret_cast<const Uint8*>(pixels.data());
+	}
+
+	SDL_Texture* texture = SDL_CreateTexture(renderer, header.format, SDL_TEXTUREACCESS_STATIC, header.width, header.height);
+	if (texture) {
+		if (SDL_UpdateTexture(texture, nullptr, data, pitch) < 0) {
+			SDL_DestroyTexture(texture);
+			texture = nullptr;
+		} else {
+			SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+			*width = header.width;
+			*height = header.height;
+		}
+	}
+	SDL_RWclose(file);
+	return texture;
+}
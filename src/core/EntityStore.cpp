@@ -0,0 +1,355 @@
+#include <core/EntityStore.h>
+#include <core/JobSystem.h>
+#include <core/RenderQueue.h>
+
+namespace {
+
+void renderEntities(SDL_Renderer* renderer, const SDL_Rect& camera, int numEntities, const int* posX, const int* posY, const int* width, const int* height, Texture* const* textures) {
+	for (int i = 0; i < numEntities; i++) {
+		if (posX[i] + width[i] <= camera.x || posX[i] >= camera.x + camera.w ||
+			posY[i] + height[i] <= camera.y || posY[i] >= camera.y + camera.h) {
+			continue;
+		}
+		textures[i]->render(renderer, posX[i] - camera.x, posY[i] - camera.y);
+	}
+}
+
+}
+
+void EntitySnapshot::render(SDL_Renderer* renderer, const SDL_Rect& camera) const {
+	renderEntities(renderer, camera, static_cast<int>(posX.size()), posX.data(), posY.data(), width.data(), height.data(), textures.data());
+}
+
+void EntitySnapshot::record(RenderQueue& queue, const SDL_Rect& camera) const {
+	queue.record(static_cast<int>(posX.size()), [this, &camera](CommandBuffer& buffer, int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			if (posX[i] + width[i] <= camera.x || posX[i] >= camera.x + camera.w ||
+				posY[i] + height[i] <= camera.y || posY[i] >= camera.y + camera.h) {
+				continue;
+			}
+			buffer.drawSprite(layers[i], textures[i], posX[i] - camera.x, posY[i] - camera.y);
+		}
+	});
+}
+
+EntityStore::EntityStore() {
+	bounds = {0, 0, 0, 0};
+	cellSize = 1;
+	numCellsX = 0;
+	numCellsY = 0;
+}
+
+Entity EntityStore::create(int x, int y, int width, int height, Texture* texture, Uint32 flags, Uint8 layer) {
+	Entity entity;
+	if (!freeEntities.empty()) {
+		entity = freeEntities.back();
+		freeEntities.pop_back();
+	} else {
+		entity = static_cast<Entity>(indices.size());
+		indices.push_back(-1);
+	}
+	indices[entity] = static_cast<int>(entities.size());
+	entities.push_back(entity);
+	posX.push_back(x);
+	posY.push_back(y);
+	prevX.push_back(x);
+	prevY.push_back(y);
+	velX.push_back(0);
+	velY.push_back(0);
+	this->width.push_back(width);
+	this->height.push_back(height);
+	textures.push_back(texture);
+	this->flags.push_back(flags);
+	layers.push_back(layer);
+	contacts.push_back(0);
+	return entity;
+}
+
+void EntityStore::destroy(Entity entity) {
+	if (!isAlive(entity)) {
+		return;
+	}
+	int index = indices[entity];
+	int last = static_cast<int>(entities.size()) - 1;
+	posX[index] = posX[last];
+	posY[index] = posY[last];
+	prevX[index] = prevX[last];
+	prevY[index] = prevY[last];
+	velX[index] = velX[last];
+	velY[index] = velY[last];
+	width[index] = width[last];
+	height[index] = height[last];
+	textures[index] = textures[last];
+	flags[index] = flags[last];
+	layers[index] = layers[last];
+	contacts[index] = contacts[last];
+	entities[index] = entities[last];
+	indices[entities[index]] = index;
+	posX.pop_back();
+	posY.pop_back();
+	prevX.pop_back();
+	prevY.pop_back();
+	velX.pop_back();
+	velY.pop_back();
+	width.pop_back();
+	height.pop_back();
+	textures.pop_back();
+	flags.pop_back();
+	layers.pop_back();
+	contacts.pop_back();
+	entities.pop_back();
+	indices[entity] = -1;
+	freeEntities.push_back(entity);
+}
+
+void EntityStore::clear() {
+	posX.clear();
+	posY.clear();
+	prevX.clear();
+	prevY.clear();
+	velX.clear();
+	velY.clear();
+	width.clear();
+	height.clear();
+	textures.clear();
+	flags.clear();
+	layers.clear();
+	contacts.clear();
+	entities.clear();
+	indices.clear();
+	freeEntities.clear();
+	cellStart.clear();
+	cellEntities.clear();
+}
+
+bool EntityStore::isAlive(Entity entity) {
+	return entity < indices.size() && indices[entity] >= 0;
+}
+
+int EntityStore::getNumEntities() {
+	return static_cast<int>(entities.size());
+}
+
+int EntityStore::getPosX(Entity entity) {
+	return posX[indices[entity]];
+}
+
+int EntityStore::getPosY(Entity entity) {
+	return posY[indices[entity]];
+}
+
+void EntityStore::setVelocity(Entity entity, int velX, int velY) {
+	int index = indices[entity];
+	this->velX[index] = velX;
+	this->velY[index] = velY;
+}
+
+void EntityStore::handleEvent(Entity entity, SDL_Event& e, int speed) {
+	int index = indices[entity];
+	handleArrowKeys(e, speed, velX[index], velY[index]);
+}
+
+void EntityStore::setBounds(const SDL_Rect& bounds) {
+	this->bounds = bounds;
+}
+
+void EntityStore::setColliders(const std::vector<SDL_Rect>& colliders) {
+	this->colliders = colliders;
+}
+
+void EntityStore::move() {
+	JobSystem::parallelFor(getNumEntities(), [this](int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			prevX[i] = posX[i];
+			prevY[i] = posY[i];
+			posX[i] += velX[i];
+			if (isBlocked(i)) {
+				posX[i] -= velX[i];
+				if (flags[i] & ENTITY_FLAG_BOUNCE) {
+					velX[i] = -velX[i];
+				}
+			}
+			posY[i] += velY[i];
+			if (isBlocked(i)) {
+				posY[i] -= velY[i];
+				if (flags[i] & ENTITY_FLAG_BOUNCE) {
+					velY[i] = -velY[i];
+				}
+			}
+		}
+	});
+}
+
+void EntityStore::collide() {
+	buildGrid();
+	if (cellEntities.empty()) {
+		return;
+	}
+	// Contacts are gathered before anything moves so every entity sees the
+	// same positions no matter how the range is split between workers.
+	JobSystem::parallelFor(getNumEntities(), [this](int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			contacts[i] = findContacts(i);
+		}
+	});
+	JobSystem::parallelFor(getNumEntities(), [this](int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			if (contacts[i]) {
+				resolveContacts(i, contacts[i]);
+			}
+		}
+	});
+}
+
+void EntityStore::render(SDL_Renderer* renderer, const SDL_Rect& camera) {
+	renderEntities(renderer, camera, getNumEntities(), posX.data(), posY.data(), width.data(), height.data(), textures.data());
+}
+
+void EntityStore::snapshot(EntitySnapshot& snapshot) {
+	// assign() reuses the snapshot's storage, so steady state does not allocate.
+	snapshot.posX.assign(posX.begin(), posX.end());
+	snapshot.posY.assign(posY.begin(), posY.end());
+	snapshot.width.assign(width.begin(), width.end());
+	snapshot.height.assign(height.begin(), height.end());
+	snapshot.textures.assign(textures.begin(), textures.end());
+	snapshot.layers.assign(layers.begin(), layers.end());
+}
+
+void EntityStore::handleArrowKeys(SDL_Event& e, int speed, int& velX, int& velY) {
+	if ((e.type != SDL_KEYDOWN && e.type != SDL_KEYUP) || e.key.repeat != 0) {
+		return;
+	}
+	// Key up undoes exactly what key down added, so opposite keys cancel out.
+	int delta = e.type == SDL_KEYDOWN ? speed : -speed;
+	switch (e.key.keysym.sym) {
+		case SDLK_UP: {
+			velY -= delta; break;
+		}
+		case SDLK_DOWN: {
+			velY += delta; break;
+		}
+		case SDLK_LEFT: {
+			velX -= delta; break;
+		}
+		case SDLK_RIGHT: {
+			velX += delta; break;
+		}
+		default: {
+			break;
+		}
+	}
+}
+
+bool EntityStore::isBlocked(int index) {
+	SDL_Rect rect{posX[index], posY[index], width[index], height[index]};
+	if (rect.x < bounds.x || rect.x + rect.w > bounds.x + bounds.w ||
+		rect.y < bounds.y || rect.y + rect.h > bounds.y + bounds.h) {
+		return true;
+	}
+	for (const auto& collider : colliders) {
+		if (rect.x + rect.w > collider.x && rect.x < collider.x + collider.w &&
+			rect.y + rect.h > collider.y && rect.y < collider.y + collider.h) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void EntityStore::buildGrid() {
+	// Solid entities are counting-sorted by the cell of their top-left corner.
+	// Cells are as large as the largest solid entity, so anything overlapping
+	// an entity starts at most one cell above or to the left of it.
+	int numEntities = getNumEntities();
+	cellSize = 1;
+	int numSolid = 0;
+	for (int i = 0; i < numEntities; i++) {
+		if (flags[i] & ENTITY_FLAG_SOLID) {
+			cellSize = SDL_max(cellSize, SDL_max(width[i], height[i]));
+			numSolid++;
+		}
+	}
+	cellEntities.resize(numSolid);
+	if (numSolid == 0) {
+		return;
+	}
+	numCellsX = bounds.w / cellSize + 1;
+	numCellsY = bounds.h / cellSize + 1;
+	cellStart.assign(numCellsX * numCellsY + 1, 0);
+	for (int i = 0; i < numEntities; i++) {
+		if (flags[i] & ENTITY_FLAG_SOLID) {
+			int cellX = getCell(posX[i], bounds.x, numCellsX);
+			int cellY = getCell(posY[i], bounds.y, numCellsY);
+			cellStart[cellY * numCellsX + cellX + 1]++;
+		}
+	}
+	for (size_t cell = 1; cell < cellStart.size(); cell++) {
+		cellStart[cell] += cellStart[cell - 1];
+	}
+	std::vector<int> cellEnd(cellStart.begin(), cellStart.end() - 1);
+	for (int i = 0; i < numEntities; i++) {
+		if (flags[i] & ENTITY_FLAG_SOLID) {
+			int cellX = getCell(posX[i], bounds.x, numCellsX);
+			int cellY = getCell(posY[i], bounds.y, numCellsY);
+			cellEntities[cellEnd[cellY * numCellsX + cellX]++] = i;
+		}
+	}
+}
+
+int EntityStore::getCell(int position, int origin, int numCells) {
+	int cell = (position - origin) / cellSize;
+	return SDL_max(0, SDL_min(cell, numCells - 1));
+}
+
+Uint8 EntityStore::findContacts(int index) {
+	Uint8 result = 0;
+	int x = posX[index];
+	int y = posY[index];
+	int w = width[index];
+	int h = height[index];
+	int firstCellX = getCell(x - cellSize, bounds.x, numCellsX);
+	int lastCellX = getCell(x + w, bounds.x, numCellsX);
+	int firstCellY = getCell(y - cellSize, bounds.y, numCellsY);
+	int lastCellY = getCell(y + h, bounds.y, numCellsY);
+	for (int cellY = firstCellY; cellY <= lastCellY; cellY++) {
+		for (int cellX = firstCellX; cellX <= lastCellX; cellX++) {
+			int cell = cellY * numCellsX + cellX;
+			for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++) {
+				int other = cellEntities[k];
+				if (other == index) {
+					continue;
+				}
+				int overlapX = SDL_min(x + w, posX[other] + width[other]) - SDL_max(x, posX[other]);
+				int overlapY = SDL_min(y + h, posY[other] + height[other]) - SDL_max(y, posY[other]);
+				if (overlapX <= 0 || overlapY <= 0) {
+					continue;
+				}
+				// Push out along the axis with the smaller overlap, comparing
+				// doubled centers to stay in integers.
+				if (overlapX < overlapY) {
+					result |= 2 * x + w < 2 * posX[other] + width[other] ? CONTACT_RIGHT : CONTACT_LEFT;
+				} else {
+					result |= 2 * y + h < 2 * posY[other] + height[other] ? CONTACT_DOWN : CONTACT_UP;
+				}
+			}
+		}
+	}
+	return result;
+}
+
+void EntityStore::resolveContacts(int index, Uint8 contact) {
+	if (!(flags[index] & ENTITY_FLAG_BOUNCE)) {
+		posX[index] = prevX[index];
+		posY[index] = prevY[index];
+		return;
+	}
+	if (contact & CONTACT_RIGHT) {
+		velX[index] = -SDL_abs(velX[index]);
+	} else if (contact & CONTACT_LEFT) {
+		velX[index] = SDL_abs(velX[index]);
+	}
+	if (contact & CONTACT_DOWN) {
+		velY[index] = -SDL_abs(velY[index]);
+	} else if (contact & CONTACT_UP) {
+		velY[index] = SDL_abs(velY[index]);
+	}
+}
@@ -0,0 +1,169 @@
+#include <core/EventBus.h>
+#include <iterator>
+
+EventBus::EventBus() {
+	nextID = 1;
+	coalesceMouseMotion = true;
+	needsCompact = false;
+	numDispatched = 0;
+	numCoalesced = 0;
+}
+
+int EventBus::subscribe(Uint32 type, EventHandler handler) {
+	return subscribe(type, 0, handler);
+}
+
+int EventBus::subscribe(Uint32 type, Uint32 windowID, EventHandler handler) {
+	Uint64 key = makeKey(type, windowID);
+	int id = nextID++;
+	handlers[key].push_back(Handler{id, handler});
+	handlerKeys[id] = key;
+	return id;
+}
+
+void EventBus::unsubscribe(int id) {
+	auto key = handlerKeys.find(id);
+	if (key == handlerKeys.end()) {
+		return;
+	}
+	for (auto& handler : handlers[key->second]) {
+		if (handler.id == id) {
+			handler.function = nullptr;
+		}
+	}
+	handlerKeys.erase(key);
+	needsCompact = true;
+}
+
+void EventBus::setCoalesceMouseMotion(bool coalesce) {
+	coalesceMouseMotion = coalesce;
+}
+
+int EventBus::dispatch() {
+	drain();
+	if (coalesceMouseMotion) {
+		coalesce();
+	}
+	for (auto& event : events) {
+		Uint32 windowID = getWindowID(event);
+		if (windowID != 0) {
+			deliver(makeKey(event.type, windowID), event);
+		}
+		deliver(makeKey(event.type, 0), event);
+	}
+	int numEvents = static_cast<int>(events.size());
+	numDispatched += numEvents;
+	events.clear();
+	if (needsCompact) {
+		compact();
+	}
+	return numEvents;
+}
+
+int EventBus::getNumDispatched() {
+	return numDispatched;
+}
+
+int EventBus::getNumCoalesced() {
+	return numCoalesced;
+}
+
+Uint32 EventBus::getWindowID(const SDL_Event& event) {
+	switch (event.type) {
+		case SDL_WINDOWEVENT: {
+			return event.window.windowID;
+		}
+		case SDL_KEYDOWN:
+		case SDL_KEYUP: {
+			return event.key.windowID;
+		}
+		case SDL_TEXTEDITING: {
+			return event.edit.windowID;
+		}
+		case SDL_TEXTINPUT: {
+			return event.text.windowID;
+		}
+		case SDL_MOUSEMOTION: {
+			return event.motion.windowID;
+		}
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP: {
+			return event.button.windowID;
+		}
+		case SDL_MOUSEWHEEL: {
+			return event.wheel.windowID;
+		}
+		default: {
+			return event.type >= SDL_USEREVENT ? event.user.windowID : 0;
+		}
+	}
+}
+
+void EventBus::drain() {
+	SDL_PumpEvents();
+	while (true) {
+		size_t offset = events.size();
+		events.resize(offset + EVENT_BATCH_SIZE);
+		int numEvents = SDL_PeepEvents(&events[offset], EVENT_BATCH_SIZE, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+		events.resize(offset + SDL_max(numEvents, 0));
+		if (numEvents < EVENT_BATCH_SIZE) {
+			break;
+		}
+	}
+}
+
+void EventBus::coalesce() {
+	size_t count = 0;
+	int lastMotion = -1;
+	for (size_t i = 0; i < events.size(); i++) {
+		SDL_Event& event = events[i];
+		if (event.type == SDL_MOUSEMOTION && lastMotion >= 0) {
+			SDL_MouseMotionEvent& previous = events[lastMotion].motion;
+			if (previous.windowID == event.motion.windowID && previous.which == event.motion.which && previous.state == event.motion.state) {
+				previous.timestamp = event.motion.timestamp;
+				previous.x = event.motion.x;
+				previous.y = event.motion.y;
+				previous.xrel += event.motion.xrel;
+				previous.yrel += event.motion.yrel;
+				numCoalesced++;
+				continue;
+			}
+		}
+		lastMotion = event.type == SDL_MOUSEMOTION ? static_cast<int>(count) : -1;
+		events[count++] = event;
+	}
+	events.resize(count);
+}
+
+void EventBus::deliver(Uint64 key, SDL_Event& event) {
+	auto it = handlers.find(key);
+	if (it == handlers.end()) {
+		return;
+	}
+	std::vector<Handler>& list = it->second;
+	for (size_t i = 0; i < list.size(); i++) {
+		EventHandler function = list[i].function;
+		if (function) {
+			function(event);
+		}
+	}
+}
+
+void EventBus::compact() {
+	for (auto it = handlers.begin(); it != handlers.end();) {
+		auto& list = it->second;
+		for (size_t i = 0; i < list.size();) {
+			if (!list[i].function) {
+				list.erase(list.begin() + i);
+			} else {
+				i++;
+			}
+		}
+		it = list.empty() ? handlers.erase(it) : std::next(it);
+	}
+	needsCompact = false;
+}
+
+Uint64 EventBus::makeKey(Uint32 type, Uint32 windowID) {
+	return (static_cast<Uint64>(type) << 32) | windowID;
+}
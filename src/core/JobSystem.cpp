@@ -0,0 +1,190 @@
+#include <core/JobSystem.h>
+#include <stdint.h>
+#include <stdio.h>
+
+std::vector<JobSystem::WorkerQueue*> JobSystem::queues;
+std::vector<SDL_Thread*> JobSystem::workers;
+SDL_sem* JobSystem::semaphore = nullptr;
+SDL_atomic_t JobSystem::quitting;
+thread_local int JobSystem::currentQueue = -1;
+
+JobCounter::JobCounter() {
+	SDL_AtomicSet(&pending, 0);
+	lock = 0;
+}
+
+bool JobCounter::isDone() {
+	return SDL_AtomicGet(&pending) == 0;
+}
+
+bool JobSystem::init(int numWorkers) {
+	quit();
+	if (numWorkers < 0) {
+		numWorkers = SDL_GetCPUCount() - 1;
+	}
+	semaphore = SDL_CreateSemaphore(0);
+	if (!semaphore) {
+		printf("Unable to create job semaphore! Error: %s\n", SDL_GetError());
+		return false;
+	}
+	SDL_AtomicSet(&quitting, 0);
+	for (int i = 0; i <= numWorkers; i++) {
+		queues.push_back(new WorkerQueue());
+	}
+	for (int i = 0; i < numWorkers; i++) {
+		SDL_Thread* worker = SDL_CreateThread(workerThread, "JobSystem", reinterpret_cast<void*>(static_cast<intptr_t>(i)));
+		if (!worker) {
+			printf("Warning: Unable to create job thread! Error: %s\n", SDL_GetError());
+			break;
+		}
+		workers.push_back(worker);
+	}
+	return true;
+}
+
+void JobSystem::quit() {
+	SDL_AtomicSet(&quitting, 1);
+	for (size_t i = 0; i < workers.size(); i++) {
+		SDL_SemPost(semaphore);
+	}
+	for (auto worker : workers) {
+		SDL_WaitThread(worker, nullptr);
+	}
+	workers.clear();
+	for (auto queue : queues) {
+		delete queue;
+	}
+	queues.clear();
+	if (semaphore) {
+		SDL_DestroySemaphore(semaphore);
+		semaphore = nullptr;
+	}
+}
+
+void JobSystem::submit(JobFunction function, JobCounter* counter, JobCounter* dependency) {
+	Job job{function, counter};
+	if (counter) {
+		SDL_AtomicIncRef(&counter->pending);
+	}
+	if (dependency) {
+		SDL_AtomicLock(&dependency->lock);
+		if (SDL_AtomicGet(&dependency->pending) > 0) {
+			dependency->continuations.push_back(job);
+			SDL_AtomicUnlock(&dependency->lock);
+			return;
+		}
+		SDL_AtomicUnlock(&dependency->lock);
+	}
+	push(job);
+}
+
+void JobSystem::wait(JobCounter* counter) {
+	while (!counter->isDone()) {
+		Job job;
+		if (pop(job)) {
+			execute(job);
+		} else {
+			SDL_Delay(0);
+		}
+	}
+	// The last job may still be releasing the counter's lock; the caller is free
+	// to destroy the counter once this returns.
+	SDL_AtomicLock(&counter->lock);
+	SDL_AtomicUnlock(&counter->lock);
+}
+
+void JobSystem::parallelFor(int count, RangeFunction function, int grainSize) {
+	if (count <= 0) {
+		return;
+	}
+	int numThreads = getNumThreads();
+	if (grainSize <= 0) {
+		grainSize = SDL_max(count / (numThreads * 4), 1);
+	}
+	if (numThreads == 1 || count <= grainSize) {
+		function(0, count);
+		return;
+	}
+	JobCounter counter;
+	for (int begin = grainSize; begin < count; begin += grainSize) {
+		int end = SDL_min(begin + grainSize, count);
+		submit([&function, begin, end]() {
+			function(begin, end);
+		}, &counter);
+	}
+	function(0, grainSize);
+	wait(&counter);
+}
+
+int JobSystem::getNumThreads() {
+	return static_cast<int>(workers.size()) + 1;
+}
+
+int JobSystem::workerThread(void* data) {
+	currentQueue = static_cast<int>(reinterpret_cast<intptr_t>(data));
+	while (true) {
+		SDL_SemWait(semaphore);
+		if (SDL_AtomicGet(&quitting)) {
+			break;
+		}
+		Job job;
+		while (pop(job)) {
+			execute(job);
+		}
+	}
+	return 0;
+}
+
+void JobSystem::push(Job& job) {
+	if (queues.empty()) {
+		execute(job);
+		return;
+	}
+	int index = currentQueue >= 0 ? currentQueue : static_cast<int>(queues.size()) - 1;
+	WorkerQueue* queue = queues[index];
+	SDL_AtomicLock(&queue->lock);
+	queue->jobs.push_back(job);
+	SDL_AtomicUnlock(&queue->lock);
+	SDL_SemPost(semaphore);
+}
+
+bool JobSystem::pop(Job& job) {
+	int numQueues = static_cast<int>(queues.size());
+	int own = currentQueue >= 0 ? currentQueue : numQueues - 1;
+	for (int i = 0; i < numQueues; i++) {
+		WorkerQueue* queue = queues[(own + i) % numQueues];
+		SDL_AtomicLock(&queue->lock);
+		if (!queue->jobs.empty()) {
+			if (i == 0) {
+				job = queue->jobs.back();
+				queue->jobs.pop_back();
+			} else {
+				job = queue->jobs.front();
+				queue->jobs.pop_front();
+			}
+			SDL_AtomicUnlock(&queue->lock);
+			return true;
+		}
+		SDL_AtomicUnlock(&queue->lock);
+	}
+	return false;
+}
+
+void JobSystem::execute(Job& job) {
+	job.function();
+	if (job.counter) {
+		finish(job.counter);
+	}
+}
+
+void JobSystem::finish(JobCounter* counter) {
+	std::vector<Job> ready;
+	SDL_AtomicLock(&counter->lock);
+	if (SDL_AtomicDecRef(&counter->pending)) {
+		ready.swap(counter->continuations);
+	}
+	SDL_AtomicUnlock(&counter->lock);
+	for (auto& job : ready) {
+		push(job);
+	}
+}
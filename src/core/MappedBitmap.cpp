@@ -0,0 +1,151 @@
+#include <core/MappedBitmap.h>
+#include <core/AssetPack.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace {
+
+constexpr size_t BMP_FILE_HEADER_SIZE = 14;
+constexpr size_t BMP_INFO_HEADER_SIZE = 40;
+constexpr Uint32 BMP_RGB = 0;
+constexpr Uint32 BMP_BITFIELDS = 3;
+
+Uint16 readUint16(const Uint8* data) {
+	Uint16 value;
+	memcpy(&value, data, sizeof(value));
+	return SDL_SwapLE16(value);
+}
+
+Uint32 readUint32(const Uint8* data) {
+	Uint32 value;
+	memcpy(&value, data, sizeof(value));
+	return SDL_SwapLE32(value);
+}
+
+}
+
+MappedBitmap::MappedBitmap() {
+	surface = nullptr;
+	zeroCopy = false;
+}
+
+MappedBitmap::~MappedBitmap() {
+	free();
+}
+
+bool MappedBitmap::load(std::string path, const SDL_PixelFormat* format) {
+	free();
+	const Uint8* data = nullptr;
+	size_t size = 0;
+	if (!AssetPack::findMounted(path, &data, &size)) {
+		if (file.open(path, false)) {
+			data = file.getData();
+			size = static_cast<size_t>(file.getSize());
+		}
+	}
+	if (data && loadMapped(data, size, format)) {
+		if (!zeroCopy) {
+			file.close();
+		}
+		return true;
+	}
+	file.close();
+
+	SDL_Surface* loadedSurface = SDL_LoadBMP_RW(AssetPack::openFile(path), 1);
+	if (!loadedSurface) {
+		return false;
+	}
+	surface = SDL_ConvertSurface(loadedSurface, format, 0);
+	SDL_FreeSurface(loadedSurface);
+	return surface != nullptr;
+}
+
+void MappedBitmap::free() {
+	if (surface) {
+		SDL_FreeSurface(surface);
+		surface = nullptr;
+	}
+	file.close();
+	zeroCopy = false;
+}
+
+SDL_Surface* MappedBitmap::getSurface() {
+	return surface;
+}
+
+bool MappedBitmap::isZeroCopy() {
+	return zeroCopy;
+}
+
+bool MappedBitmap::loadMapped(const Uint8* data, size_t size, const SDL_PixelFormat* format) {
+	if (size < BMP_FILE_HEADER_SIZE + BMP_INFO_HEADER_SIZE || data[0] != 'B' || data[1] != 'M') {
+		return false;
+	}
+	const Uint8* info = data + BMP_FILE_HEADER_SIZE;
+	Uint32 pixelsOffset = readUint32(data + 10);
+	Uint32 infoSize = readUint32(info);
+	Sint32 width = static_cast<Sint32>(readUint32(info + 4));
+	Sint32 height = static_cast<Sint32>(readUint32(info + 8));
+	Uint16 bitsPerPixel = readUint16(info + 14);
+	Uint32 compression = readUint32(info + 16);
+	if (infoSize < BMP_INFO_HEADER_SIZE || width <= 0 || height == 0 || height == SDL_MIN_SINT32 || (bitsPerPixel != 24 && bitsPerPixel != 32)) {
+		return false;
+	}
+
+	Uint32 rmask = 0x00FF0000;
+	Uint32 gmask = 0x0000FF00;
+	Uint32 bmask = 0x000000FF;
+	Uint32 amask = 0;
+	if (compression == BMP_BITFIELDS) {
+		// The alpha mask is only present in the larger info headers.
+		bool hasAlphaMask = infoSize >= BMP_INFO_HEADER_SIZE + 16;
+		size_t masksSize = hasAlphaMask ? 16 : 12;
+		if (bitsPerPixel != 32 || BMP_FILE_HEADER_SIZE + BMP_INFO_HEADER_SIZE + masksSize > size) {
+			return false;
+		}
+		const Uint8* masks = info + BMP_INFO_HEADER_SIZE;
+		rmask = readUint32(masks);
+		gmask = readUint32(masks + 4);
+		bmask = readUint32(masks + 8);
+		if (hasAlphaMask) {
+			amask = readUint32(masks + 12);
+		}
+	} else if (compression != BMP_RGB) {
+		return false;
+	}
+	Uint32 sourceFormat = SDL_MasksToPixelFormatEnum(bitsPerPixel, rmask, gmask, bmask, amask);
+	if (sourceFormat == SDL_PIXELFORMAT_UNKNOWN) {
+		return false;
+	}
+
+	bool topDown = height < 0;
+	height = topDown ? -height : height;
+	Sint64 pitch = ((static_cast<Sint64>(width) * bitsPerPixel + 31) / 32) * 4;
+	if (pixelsOffset > size || static_cast<Sint64>(size - pixelsOffset) < pitch * height || pitch > SDL_MAX_SINT32) {
+		return false;
+	}
+	const Uint8* pixels = data + pixelsOffset;
+
+	bool aligned = (reinterpret_cast<uintptr_t>(pixels) & 3) == 0;
+	if (topDown && aligned && sourceFormat == format->format) {
+		surface = SDL_CreateRGBSurfaceFrom(const_cast<Uint8*>(pixels), width, height, bitsPerPixel, static_cast<int>(pitch), rmask, gmask, bmask, amask);
+		zeroCopy = surface != nullptr;
+		return zeroCopy;
+	}
+
+	surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, format->BitsPerPixel, format->format);
+	if (!surface) {
+		return false;
+	}
+	file.prefetch();
+	for (int y = 0; y < height; y++) {
+		const Uint8* row = pixels + (topDown ? y : height - 1 - y) * pitch;
+		Uint8* destination = static_cast<Uint8*>(surface->pixels) + y * surface->pitch;
+		if (SDL_ConvertPixels(width, 1, sourceFormat, row, static_cast<int>(pitch), format->format, destination, surface->pitch) < 0) {
+			SDL_FreeSurface(surface);
+			surface = nullptr;
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,276 @@
+#include <core/MappedFile.h>
+#include <stdio.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct MappedFileCursor {
+	MappedFile* file;
+	Sint64 position;
+};
+
+MappedFileCursor* getCursor(SDL_RWops* context) {
+	return static_cast<MappedFileCursor*>(context->hidden.unknown.data1);
+}
+
+Sint64 SDLCALL mappedFileSize(SDL_RWops* context) {
+	return getCursor(context)->file->getSize();
+}
+
+Sint64 SDLCALL mappedFileSeek(SDL_RWops* context, Sint64 offset, int whence) {
+	MappedFileCursor* cursor = getCursor(context);
+	Sint64 position = offset;
+	if (whence == RW_SEEK_CUR) {
+		position += cursor->position;
+	} else if (whence == RW_SEEK_END) {
+		position += cursor->file->getSize();
+	} else if (whence != RW_SEEK_SET) {
+		return SDL_SetError("Unknown value for 'whence'");
+	}
+	if (position < 0) {
+		return SDL_SetError("Seek before the beginning of the mapped file");
+	}
+	cursor->position = position;
+	return position;
+}
+
+size_t SDLCALL mappedFileRead(SDL_RWops* context, void* ptr, size_t size, size_t maxnum) {
+	MappedFileCursor* cursor = getCursor(context);
+	if (size == 0) {
+		return 0;
+	}
+	Sint64 available = cursor->file->getSize() - cursor->position;
+	if (available <= 0) {
+		return 0;
+	}
+	size_t num = SDL_min(maxnum, static_cast<size_t>(available) / size);
+	SDL_memcpy(ptr, cursor->file->getData() + cursor->position, num * size);
+	cursor->position += num * size;
+	return num;
+}
+
+size_t SDLCALL mappedFileWrite(SDL_RWops* context, const void* ptr, size_t size, size_t num) {
+	MappedFileCursor* cursor = getCursor(context);
+	if (!cursor->file->isWritable()) {
+		SDL_SetError("Mapped file is read-only");
+		return 0;
+	}
+	Sint64 end = cursor->position + static_cast<Sint64>(size * num);
+	if (end > cursor->file->getSize() && !cursor->file->resize(end)) {
+		return 0;
+	}
+	SDL_memcpy(cursor->file->getData() + cursor->position, ptr, size * num);
+	cursor->position = end;
+	return num;
+}
+
+int SDLCALL mappedFileClose(SDL_RWops* context) {
+	delete getCursor(context);
+	SDL_FreeRW(context);
+	return 0;
+}
+
+}
+
+MappedFile::MappedFile() {
+	data = nullptr;
+	size = 0;
+	writable = false;
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = nullptr;
+#else
+	fileDescriptor = -1;
+#endif
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(std::string path, bool write, Sint64 minSize) {
+	close();
+	writable = write;
+#ifdef _WIN32
+	DWORD access = writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+	DWORD disposition = writable ? OPEN_ALWAYS : OPEN_EXISTING;
+	fileHandle = CreateFileA(path.c_str(), access, FILE_SHARE_READ, nullptr, disposition, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		SDL_SetError("Unable to open \"%s\"", path.c_str());
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize)) {
+		SDL_SetError("Unable to get the size of \"%s\"", path.c_str());
+		close();
+		return false;
+	}
+	size = fileSize.QuadPart;
+#else
+	fileDescriptor = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+	if (fileDescriptor < 0) {
+		SDL_SetError("Unable to open \"%s\"", path.c_str());
+		return false;
+	}
+	struct stat fileStat;
+	if (fstat(fileDescriptor, &fileStat) < 0) {
+		SDL_SetError("Unable to get the size of \"%s\"", path.c_str());
+		close();
+		return false;
+	}
+	size = fileStat.st_size;
+#endif
+	bool success = (writable && size < minSize) ? resize(minSize) : map();
+	if (!success) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool MappedFile::resize(Sint64 newSize) {
+	if (!writable) {
+		SDL_SetError("Mapped file is read-only");
+		return false;
+	}
+	unmap();
+#ifdef _WIN32
+	LARGE_INTEGER fileSize;
+	fileSize.QuadPart = newSize;
+	if (!SetFilePointerEx(fileHandle, fileSize, nullptr, FILE_BEGIN) || !SetEndOfFile(fileHandle)) {
+		SDL_SetError("Unable to resize mapped file");
+		return false;
+	}
+#else
+	if (ftruncate(fileDescriptor, newSize) != 0) {
+		SDL_SetError("Unable to resize mapped file");
+		return false;
+	}
+#endif
+	size = newSize;
+	return map();
+}
+
+void MappedFile::flush() {
+	if (data && writable) {
+#ifdef _WIN32
+		FlushViewOfFile(data, 0);
+		FlushFileBuffers(fileHandle);
+#else
+		msync(data, size, MS_SYNC);
+#endif
+	}
+}
+
+void MappedFile::prefetch() {
+	if (data) {
+#ifdef _WIN32
+		volatile Uint8 sink = 0;
+		for (Sint64 offset = 0; offset < size; offset += 4096) {
+			sink ^= data[offset];
+		}
+#else
+		posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+		posix_madvise(data, size, POSIX_MADV_WILLNEED);
+#endif
+	}
+}
+
+void MappedFile::close() {
+	unmap();
+#ifdef _WIN32
+	if (fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(fileHandle);
+		fileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (fileDescriptor >= 0) {
+		::close(fileDescriptor);
+		fileDescriptor = -1;
+	}
+#endif
+	size = 0;
+}
+
+SDL_RWops* MappedFile::createRWops() {
+	SDL_RWops* context = SDL_AllocRW();
+	if (context) {
+		context->size = mappedFileSize;
+		context->seek = mappedFileSeek;
+		context->read = mappedFileRead;
+		context->write = mappedFileWrite;
+		context->close = mappedFileClose;
+		context->type = SDL_RWOPS_UNKNOWN;
+		context->hidden.unknown.data1 = new MappedFileCursor{this, 0};
+	}
+	return context;
+}
+
+Uint8* MappedFile::getData() {
+	return data;
+}
+
+Sint64 MappedFile::getSize() {
+	return size;
+}
+
+bool MappedFile::isOpen() {
+#ifdef _WIN32
+	return fileHandle != INVALID_HANDLE_VALUE;
+#else
+	return fileDescriptor >= 0;
+#endif
+}
+
+bool MappedFile::isWritable() {
+	return writable;
+}
+
+bool MappedFile::map() {
+	if (size == 0) {
+		return true;
+	}
+#ifdef _WIN32
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+	if (!mappingHandle) {
+		SDL_SetError("Unable to create file mapping");
+		return false;
+	}
+	data = static_cast<Uint8*>(MapViewOfFile(mappingHandle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+	if (!data) {
+		CloseHandle(mappingHandle);
+		mappingHandle = nullptr;
+		SDL_SetError("Unable to map view of file");
+		return false;
+	}
+#else
+	void* address = mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fileDescriptor, 0);
+	if (address == MAP_FAILED) {
+		SDL_SetError("Unable to map file");
+		return false;
+	}
+	data = static_cast<Uint8*>(address);
+#endif
+	return true;
+}
+
+void MappedFile::unmap() {
+	if (data) {
+#ifdef _WIN32
+		UnmapViewOfFile(data);
+		CloseHandle(mappingHandle);
+		mappingHandle = nullptr;
+#else
+		munmap(data, size);
+#endif
+		data = nullptr;
+	}
+}
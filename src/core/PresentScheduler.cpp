@@ -0,0 +1,67 @@
+#include <core/PresentScheduler.h>
+#include <stdio.h>
+
+PresentScheduler::PresentScheduler() {
+	nextFrame = 0;
+	numFrames = 0;
+	numPresents = 0;
+	numTimedFrames = 0;
+}
+
+void PresentScheduler::add(WindowEx* window) {
+	windows.push_back(window);
+}
+
+void PresentScheduler::clear() {
+	windows.clear();
+}
+
+void PresentScheduler::present() {
+	WindowEx* pacer = findPacer();
+	for (auto window : windows) {
+		if (window != pacer && (window->isVisible() || window->needsRedraw())) {
+			window->render();
+			numPresents++;
+		}
+	}
+	if (pacer) {
+		// The only present that waits for vsync.
+		pacer->render();
+		numPresents++;
+		nextFrame = 0;
+	} else {
+		waitForNextFrame();
+		numTimedFrames++;
+	}
+	numFrames++;
+}
+
+void PresentScheduler::printStatistics() {
+	if (numFrames > 0) {
+		printf("Present scheduler: %llu frames, %.2f presents per frame, %llu paced by timer\n", static_cast<unsigned long long>(numFrames), static_cast<double>(numPresents) / numFrames, static_cast<unsigned long long>(numTimedFrames));
+	}
+}
+
+WindowEx* PresentScheduler::findPacer() {
+	for (auto window : windows) {
+		if (window->hasVsync() && window->isVisible()) {
+			return window;
+		}
+	}
+	return nullptr;
+}
+
+void PresentScheduler::waitForNextFrame() {
+	if (windows.empty()) {
+		return;
+	}
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+	Uint64 frameTicks = frequency / windows[0]->getRefreshRate();
+	Uint64 now = SDL_GetPerformanceCounter();
+	if (nextFrame > now) {
+		SDL_Delay(static_cast<Uint32>((nextFrame - now) * 1000 / frequency));
+		nextFrame += frameTicks;
+	} else {
+		nextFrame = now + frameTicks;
+	}
+}
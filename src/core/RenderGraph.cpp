@@ -0,0 +1,200 @@
+#include <core/RenderGraph.h>
+#include <core/TiledRenderer.h>
+#include <stdio.h>
+
+RenderGraph::RenderGraph() {
+	renderer = nullptr;
+	targetsSupported = false;
+	numFrames = 0;
+	numPasses = 0;
+	numCulled = 0;
+	numCreated = 0;
+}
+
+RenderGraph::~RenderGraph() {
+	free();
+}
+
+bool RenderGraph::init(SDL_Renderer* renderer) {
+	free();
+	this->renderer = renderer;
+	targetsSupported = SDL_RenderTargetSupported(renderer) && !TiledRenderer::find(renderer);
+	resources.push_back(Resource{0, 0, SDL_BLENDMODE_NONE, nullptr, -1, -1});
+	return true;
+}
+
+void RenderGraph::free() {
+	for (auto& target : pool) {
+		SDL_DestroyTexture(target.texture);
+	}
+	pool.clear();
+	passes.clear();
+	resources.clear();
+	renderer = nullptr;
+	targetsSupported = false;
+}
+
+bool RenderGraph::supportsTargets() {
+	return targetsSupported;
+}
+
+RenderGraphResource RenderGraph::createTarget(int width, int height, SDL_BlendMode blendMode) {
+	resources.push_back(Resource{width, height, blendMode, nullptr, -1, -1});
+	return static_cast<RenderGraphResource>(resources.size()) - 1;
+}
+
+void RenderGraph::addPass(std::string name, std::vector<RenderGraphResource> inputs, RenderGraphResource output, RenderPassFunction function) {
+	passes.push_back(Pass{name, inputs, output, function, false});
+}
+
+SDL_Texture* RenderGraph::getTexture(RenderGraphResource resource) {
+	return resources[resource].texture;
+}
+
+void RenderGraph::execute() {
+	cull();
+	computeLifetimes();
+	for (int i = 0; i < static_cast<int>(passes.size()); i++) {
+		Pass& pass = passes[i];
+		if (!pass.live) {
+			continue;
+		}
+		bool ready = true;
+		for (auto& resource : resources) {
+			if (resource.firstPass == i && !acquire(resource)) {
+				ready = false;
+			}
+		}
+		if (ready) {
+			if (targetsSupported) {
+				SDL_SetRenderTarget(renderer, resources[pass.output].texture);
+			}
+			pass.function(renderer);
+		} else {
+			printf("Skipping render pass \"%s\", its targets are unavailable!\n", pass.name.c_str());
+		}
+		for (auto& resource : resources) {
+			if (resource.lastPass == i) {
+				release(resource);
+			}
+		}
+	}
+	if (targetsSupported) {
+		SDL_SetRenderTarget(renderer, nullptr);
+	}
+	numFrames++;
+	trimPool();
+	passes.clear();
+	resources.resize(1);
+}
+
+void RenderGraph::printStatistics() {
+	if (numFrames > 0) {
+		printf("Render graph: %llu frames, %.1f passes and %.1f culled per frame, %llu targets created, %d pooled\n", static_cast<unsigned long long>(numFrames), static_cast<double>(numPasses) / numFrames, static_cast<double>(numCulled) / numFrames, static_cast<unsigned long long>(numCreated), getNumPooled());
+	}
+}
+
+int RenderGraph::getNumPooled() {
+	return static_cast<int>(pool.size());
+}
+
+void RenderGraph::cull() {
+	// Walk back from the last pass. A pass is live when something later needs
+	// its output; its inputs are then needed in turn. Outputs stay needed after
+	// a live writer, since passes draw over what earlier writers left there.
+	std::vector<bool> needed(resources.size(), false);
+	needed[RENDER_GRAPH_BACKBUFFER] = true;
+	for (int i = static_cast<int>(passes.size()) - 1; i >= 0; i--) {
+		Pass& pass = passes[i];
+		pass.live = needed[pass.output];
+		if (!targetsSupported && pass.output != RENDER_GRAPH_BACKBUFFER) {
+			pass.live = false;
+		}
+		if (pass.live) {
+			for (auto input : pass.inputs) {
+				needed[input] = true;
+			}
+			numPasses++;
+		} else {
+			numCulled++;
+		}
+	}
+}
+
+void RenderGraph::computeLifetimes() {
+	for (auto& resource : resources) {
+		resource.firstPass = -1;
+		resource.lastPass = -1;
+	}
+	if (!targetsSupported) {
+		return;
+	}
+	for (int i = 0; i < static_cast<int>(passes.size()); i++) {
+		if (!passes[i].live) {
+			continue;
+		}
+		for (auto input : passes[i].inputs) {
+			Resource& resource = resources[input];
+			resource.firstPass = resource.firstPass < 0 ? i : resource.firstPass;
+			resource.lastPass = i;
+		}
+		Resource& output = resources[passes[i].output];
+		output.firstPass = output.firstPass < 0 ? i : output.firstPass;
+		output.lastPass = i;
+	}
+	// The backbuffer is never pooled.
+	resources[RENDER_GRAPH_BACKBUFFER].firstPass = -1;
+	resources[RENDER_GRAPH_BACKBUFFER].lastPass = -1;
+}
+
+bool RenderGraph::acquire(Resource& resource) {
+	PooledTarget* found = nullptr;
+	for (auto& target : pool) {
+		if (!target.inUse && target.width == resource.width && target.height == resource.height) {
+			found = &target;
+			break;
+		}
+	}
+	if (!found) {
+		SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, resource.width, resource.height);
+		if (!texture) {
+			printf("Unable to create render graph target! Error: %s\n", SDL_GetError());
+			return false;
+		}
+		numCreated++;
+		pool.push_back(PooledTarget{texture, resource.width, resource.height, 0, false});
+		found = &pool.back();
+	}
+	found->inUse = true;
+	found->lastUsedFrame = numFrames;
+	resource.texture = found->texture;
+	// Whatever an earlier target aliasing this texture left behind is cleared.
+	SDL_SetTextureBlendMode(resource.texture, resource.blendMode);
+	SDL_SetTextureAlphaMod(resource.texture, 0xFF);
+	SDL_SetTextureColorMod(resource.texture, 0xFF, 0xFF, 0xFF);
+	SDL_SetRenderTarget(renderer, resource.texture);
+	SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
+	SDL_RenderClear(renderer);
+	return true;
+}
+
+void RenderGraph::release(Resource& resource) {
+	for (auto& target : pool) {
+		if (target.texture == resource.texture) {
+			target.inUse = false;
+			break;
+		}
+	}
+}
+
+void RenderGraph::trimPool() {
+	for (size_t i = 0; i < pool.size();) {
+		if (!pool[i].inUse && pool[i].lastUsedFrame + POOL_FRAMES < numFrames) {
+			SDL_DestroyTexture(pool[i].texture);
+			pool[i] = pool.back();
+			pool.pop_back();
+		} else {
+			i++;
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#include <core/RenderLayer.h>
+#include <core/TiledRenderer.h>
+#include <stdio.h>
+
+RenderLayer::RenderLayer() {
+	renderer = nullptr;
+	texture = nullptr;
+	width = 0;
+	height = 0;
+	blendMode = SDL_BLENDMODE_BLEND;
+	dirty = true;
+	numRepainted = 0;
+}
+
+RenderLayer::~RenderLayer() {
+	free();
+}
+
+bool RenderLayer::init(SDL_Renderer* renderer, int width, int height, LayerPainter paint, SDL_BlendMode blendMode) {
+	free();
+	this->renderer = renderer;
+	this->width = width;
+	this->height = height;
+	this->paint = paint;
+	this->blendMode = blendMode;
+	dirty = true;
+	createTexture();
+	return true;
+}
+
+void RenderLayer::invalidate() {
+	dirty = true;
+}
+
+void RenderLayer::handleEvent(SDL_Event& event) {
+	if (event.type == SDL_RENDER_DEVICE_RESET && renderer) {
+		// Every texture of the renderer is gone, the layer's own included.
+		if (texture) {
+			SDL_DestroyTexture(texture);
+			texture = nullptr;
+		}
+		createTexture();
+		invalidate();
+	} else if (event.type == SDL_RENDER_TARGETS_RESET) {
+		invalidate();
+	}
+}
+
+void RenderLayer::render(int x, int y) {
+	if (texture && (!dirty || repaint())) {
+		SDL_Rect destination{x, y, width, height};
+		SDL_RenderCopy(renderer, texture, nullptr, &destination);
+		return;
+	}
+	SDL_Rect previousViewport;
+	TiledRenderer::getViewport(renderer, &previousViewport);
+	SDL_Rect viewport{x, y, width, height};
+	TiledRenderer::setViewport(renderer, &viewport);
+	paint(renderer);
+	TiledRenderer::setViewport(renderer, &previousViewport);
+}
+
+void RenderLayer::free() {
+	if (texture) {
+		SDL_DestroyTexture(texture);
+		texture = nullptr;
+	}
+	renderer = nullptr;
+	paint = nullptr;
+}
+
+bool RenderLayer::isCached() {
+	return texture != nullptr;
+}
+
+int RenderLayer::getNumRepainted() {
+	return numRepainted;
+}
+
+void RenderLayer::createTexture() {
+	if (SDL_RenderTargetSupported(renderer) && !TiledRenderer::find(renderer)) {
+		texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+		if (!texture) {
+			printf("Warning: Unable to create layer texture, painting every frame! Error: %s\n", SDL_GetError());
+		} else {
+			SDL_SetTextureBlendMode(texture, blendMode);
+		}
+	}
+}
+
+bool RenderLayer::repaint() {
+	SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+	if (SDL_SetRenderTarget(renderer, texture) < 0) {
+		printf("Unable to repaint layer! Error: %s\n", SDL_GetError());
+		return false;
+	}
+	Uint8 r, g, b, a;
+	SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+	SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
+	SDL_RenderClear(renderer);
+	paint(renderer);
+	SDL_RenderSetClipRect(renderer, nullptr);
+	SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	SDL_SetRenderTarget(renderer, previousTarget);
+	dirty = false;
+	numRepainted++;
+	return true;
+}
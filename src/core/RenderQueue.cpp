@@ -0,0 +1,212 @@
+#include <core/RenderQueue.h>
+#include <core/JobSystem.h>
+#include <core/TiledRenderer.h>
+#include <algorithm>
+#include <stdio.h>
+
+namespace {
+
+inline Uint32 packColor(const SDL_Color& color) {
+	return (static_cast<Uint32>(color.r) << 24) | (static_cast<Uint32>(color.g) << 16) | (static_cast<Uint32>(color.b) << 8) | color.a;
+}
+
+bool drawsBefore(const RenderCommand& a, const RenderCommand& b) {
+	if (a.layer != b.layer) {
+		return a.layer < b.layer;
+	}
+	if (a.texture != b.texture) {
+		return std::less<Texture*>()(a.texture, b.texture);
+	}
+	if (a.blendMode != b.blendMode) {
+		return a.blendMode < b.blendMode;
+	}
+	return packColor(a.color) < packColor(b.color);
+}
+
+}
+
+void CommandBuffer::clear() {
+	commands.clear();
+}
+
+int CommandBuffer::getNumCommands() {
+	return static_cast<int>(commands.size());
+}
+
+void CommandBuffer::drawSprite(Uint8 layer, Texture* texture, int x, int y, const SDL_Rect* clip, double angle, SDL_RendererFlip flip) {
+	RenderCommand command{};
+	command.type = RENDER_COMMAND_SPRITE;
+	command.layer = layer;
+	command.texture = texture;
+	command.rect = SDL_Rect{x, y, 0, 0};
+	if (clip) {
+		command.clipped = true;
+		command.clip = *clip;
+	}
+	command.angle = angle;
+	command.flip = flip;
+	commands.push_back(command);
+}
+
+void CommandBuffer::fillRect(Uint8 layer, const SDL_Rect& rect, SDL_Color color, SDL_BlendMode blendMode) {
+	RenderCommand command{};
+	command.type = RENDER_COMMAND_FILL_RECT;
+	command.layer = layer;
+	command.rect = rect;
+	command.color = color;
+	command.blendMode = blendMode;
+	commands.push_back(command);
+}
+
+void CommandBuffer::drawRect(Uint8 layer, const SDL_Rect& rect, SDL_Color color, SDL_BlendMode blendMode) {
+	RenderCommand command{};
+	command.type = RENDER_COMMAND_DRAW_RECT;
+	command.layer = layer;
+	command.rect = rect;
+	command.color = color;
+	command.blendMode = blendMode;
+	commands.push_back(command);
+}
+
+void CommandBuffer::drawLine(Uint8 layer, int x1, int y1, int x2, int y2, SDL_Color color, SDL_BlendMode blendMode) {
+	RenderCommand command{};
+	command.type = RENDER_COMMAND_DRAW_LINE;
+	command.layer = layer;
+	command.rect = SDL_Rect{x1, y1, x2, y2};
+	command.color = color;
+	command.blendMode = blendMode;
+	commands.push_back(command);
+}
+
+RenderQueue::RenderQueue() {
+	lock = 0;
+	nextOrder = 0;
+	numFrames = 0;
+	numCommands = 0;
+	numStateChanges = 0;
+}
+
+RenderQueue::~RenderQueue() {
+	for (auto buffer : freeBuffers) {
+		delete buffer;
+	}
+	for (auto buffer : recordedBuffers) {
+		delete buffer;
+	}
+}
+
+CommandBuffer* RenderQueue::beginBuffer() {
+	SDL_AtomicLock(&lock);
+	Uint64 order = static_cast<Uint64>(nextOrder++) << 32;
+	SDL_AtomicUnlock(&lock);
+	return acquireBuffer(order);
+}
+
+void RenderQueue::endBuffer(CommandBuffer* buffer) {
+	SDL_AtomicLock(&lock);
+	recordedBuffers.push_back(buffer);
+	SDL_AtomicUnlock(&lock);
+}
+
+void RenderQueue::record(int count, RecordFunction function) {
+	SDL_AtomicLock(&lock);
+	Uint64 order = static_cast<Uint64>(nextOrder++) << 32;
+	SDL_AtomicUnlock(&lock);
+	JobSystem::parallelFor(count, [this, order, &function](int begin, int end) {
+		CommandBuffer* buffer = acquireBuffer(order | static_cast<Uint32>(begin));
+		function(*buffer, begin, end);
+		endBuffer(buffer);
+	});
+}
+
+void RenderQueue::submit(SDL_Renderer* renderer) {
+	std::vector<CommandBuffer*> buffers;
+	SDL_AtomicLock(&lock);
+	buffers.swap(recordedBuffers);
+	nextOrder = 0;
+	SDL_AtomicUnlock(&lock);
+	std::sort(buffers.begin(), buffers.end(), [](const CommandBuffer* a, const CommandBuffer* b) {
+		return a->order < b->order;
+	});
+	merged.clear();
+	for (auto buffer : buffers) {
+		merged.insert(merged.end(), buffer->commands.begin(), buffer->commands.end());
+		buffer->clear();
+	}
+	SDL_AtomicLock(&lock);
+	freeBuffers.insert(freeBuffers.end(), buffers.begin(), buffers.end());
+	SDL_AtomicUnlock(&lock);
+	// Stable, so commands with the same layer and state keep the order they
+	// were recorded in.
+	std::stable_sort(merged.begin(), merged.end(), drawsBefore);
+	replay(renderer);
+	numFrames++;
+	numCommands += merged.size();
+}
+
+void RenderQueue::printStatistics() {
+	if (numFrames > 0) {
+		printf("Render queue: %llu frames, %.1f commands and %.1f state changes per frame\n", static_cast<unsigned long long>(numFrames), static_cast<double>(numCommands) / numFrames, static_cast<double>(numStateChanges) / numFrames);
+	}
+}
+
+CommandBuffer* RenderQueue::acquireBuffer(Uint64 order) {
+	CommandBuffer* buffer = nullptr;
+	SDL_AtomicLock(&lock);
+	if (!freeBuffers.empty()) {
+		buffer = freeBuffers.back();
+		freeBuffers.pop_back();
+	}
+	SDL_AtomicUnlock(&lock);
+	if (!buffer) {
+		buffer = new CommandBuffer();
+	}
+	buffer->order = order;
+	return buffer;
+}
+
+void RenderQueue::replay(SDL_Renderer* renderer) {
+	Texture* texture = nullptr;
+	bool hasDrawState = false;
+	SDL_Color drawColor{};
+	SDL_BlendMode drawBlendMode = SDL_BLENDMODE_NONE;
+	for (auto& command : merged) {
+		if (command.type == RENDER_COMMAND_SPRITE) {
+			if (command.texture != texture) {
+				texture = command.texture;
+				numStateChanges++;
+			}
+			SDL_Rect clip = command.clip;
+			command.texture->render(renderer, command.rect.x, command.rect.y, command.clipped ? &clip : nullptr, command.angle, nullptr, command.flip);
+			continue;
+		}
+		if (!hasDrawState || packColor(command.color) != packColor(drawColor)) {
+			drawColor = command.color;
+			TiledRenderer::setDrawColor(renderer, drawColor.r, drawColor.g, drawColor.b, drawColor.a);
+			numStateChanges++;
+		}
+		if (!hasDrawState || command.blendMode != drawBlendMode) {
+			drawBlendMode = command.blendMode;
+			TiledRenderer::setDrawBlendMode(renderer, drawBlendMode);
+			numStateChanges++;
+		}
+		hasDrawState = true;
+		switch (command.type) {
+			case RENDER_COMMAND_FILL_RECT: {
+				TiledRenderer::fillRect(renderer, &command.rect);
+				break;
+			}
+			case RENDER_COMMAND_DRAW_RECT: {
+				TiledRenderer::drawRect(renderer, &command.rect);
+				break;
+			}
+			case RENDER_COMMAND_DRAW_LINE: {
+				TiledRenderer::drawLine(renderer, command.rect.x, command.rect.y, command.rect.w, command.rect.h);
+				break;
+			}
+			default: {
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,200 @@
+#include <core/RetainedUI.h>
+#include <core/TiledRenderer.h>
+#include <stdio.h>
+
+RetainedUI::RetainedUI() {
+	renderer = nullptr;
+	compositeTexture = nullptr;
+	width = 0;
+	height = 0;
+	background = SDL_Color{0x00, 0x00, 0x00, 0x00};
+	retained = false;
+	numRepainted = 0;
+	numComposited = 0;
+}
+
+RetainedUI::~RetainedUI() {
+	free();
+}
+
+bool RetainedUI::init(SDL_Renderer* renderer, int width, int height, SDL_Color background) {
+	free();
+	this->renderer = renderer;
+	this->width = width;
+	this->height = height;
+	this->background = background;
+	retained = SDL_RenderTargetSupported(renderer) && !TiledRenderer::find(renderer);
+	if (retained) {
+		compositeTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+		if (!compositeTexture) {
+			printf("Warning: Unable to create UI composite texture, painting every frame! Error: %s\n", SDL_GetError());
+			retained = false;
+		} else {
+			SDL_SetTextureBlendMode(compositeTexture, background.a == 0xFF ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+		}
+	}
+	addDamage(SDL_Rect{0, 0, width, height});
+	return true;
+}
+
+int RetainedUI::addWidget(SDL_Rect rect, WidgetPainter paint) {
+	widgets.push_back(UIWidget{rect, paint, nullptr, true, true});
+	addDamage(rect);
+	return static_cast<int>(widgets.size()) - 1;
+}
+
+void RetainedUI::setWidgetRect(int id, SDL_Rect rect) {
+	UIWidget& widget = widgets[id];
+	if (widget.rect.w != rect.w || widget.rect.h != rect.h) {
+		if (widget.cache) {
+			SDL_DestroyTexture(widget.cache);
+			widget.cache = nullptr;
+		}
+	}
+	addDamage(widget.rect);
+	widget.rect = rect;
+	invalidate(id);
+}
+
+void RetainedUI::setWidgetVisible(int id, bool visible) {
+	if (widgets[id].visible != visible) {
+		widgets[id].visible = visible;
+		addDamage(widgets[id].rect);
+	}
+}
+
+void RetainedUI::invalidate(int id) {
+	widgets[id].dirty = true;
+	addDamage(widgets[id].rect);
+}
+
+void RetainedUI::invalidateAll() {
+	for (auto& widget : widgets) {
+		widget.dirty = true;
+	}
+	addDamage(SDL_Rect{0, 0, width, height});
+}
+
+void RetainedUI::handleEvent(SDL_Event& event) {
+	if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET) {
+		invalidateAll();
+	}
+}
+
+bool RetainedUI::update() {
+	if (damage.empty()) {
+		return false;
+	}
+	if (retained) {
+		SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+		for (auto& widget : widgets) {
+			if (widget.dirty && widget.visible && repaint(widget)) {
+				widget.dirty = false;
+				numRepainted++;
+			}
+		}
+		SDL_SetRenderTarget(renderer, compositeTexture);
+		for (const auto& region : damage) {
+			composite(region);
+		}
+		SDL_RenderSetClipRect(renderer, nullptr);
+		SDL_SetRenderTarget(renderer, previousTarget);
+	}
+	damage.clear();
+	return true;
+}
+
+void RetainedUI::render(int x, int y) {
+	if (retained) {
+		SDL_Rect destination{x, y, width, height};
+		SDL_RenderCopy(renderer, compositeTexture, nullptr, &destination);
+		return;
+	}
+	SDL_Rect previousViewport;
+	TiledRenderer::getViewport(renderer, &previousViewport);
+	for (auto& widget : widgets) {
+		if (widget.visible) {
+			SDL_Rect viewport{x + widget.rect.x, y + widget.rect.y, widget.rect.w, widget.rect.h};
+			TiledRenderer::setViewport(renderer, &viewport);
+			widget.paint(renderer, widget.rect.w, widget.rect.h);
+		}
+	}
+	TiledRenderer::setViewport(renderer, &previousViewport);
+}
+
+void RetainedUI::free() {
+	for (auto& widget : widgets) {
+		if (widget.cache) {
+			SDL_DestroyTexture(widget.cache);
+		}
+	}
+	widgets.clear();
+	damage.clear();
+	if (compositeTexture) {
+		SDL_DestroyTexture(compositeTexture);
+		compositeTexture = nullptr;
+	}
+	renderer = nullptr;
+	retained = false;
+}
+
+int RetainedUI::getNumRepainted() {
+	return numRepainted;
+}
+
+int RetainedUI::getNumComposited() {
+	return numComposited;
+}
+
+bool RetainedUI::repaint(UIWidget& widget) {
+	if (widget.rect.w <= 0 || widget.rect.h <= 0) {
+		return true;
+	}
+	if (!widget.cache) {
+		widget.cache = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, widget.rect.w, widget.rect.h);
+		if (!widget.cache) {
+			printf("Unable to create widget cache texture! Error: %s\n", SDL_GetError());
+			return false;
+		}
+		SDL_SetTextureBlendMode(widget.cache, SDL_BLENDMODE_BLEND);
+	}
+	SDL_SetRenderTarget(renderer, widget.cache);
+	SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
+	SDL_RenderClear(renderer);
+	widget.paint(renderer, widget.rect.w, widget.rect.h);
+	return true;
+}
+
+void RetainedUI::addDamage(SDL_Rect rect) {
+	SDL_Rect bounds{0, 0, width, height};
+	if (!SDL_IntersectRect(&rect, &bounds, &rect)) {
+		return;
+	}
+	for (size_t i = 0; i < damage.size();) {
+		if (SDL_HasIntersection(&damage[i], &rect)) {
+			SDL_UnionRect(&damage[i], &rect, &rect);
+			damage[i] = damage.back();
+			damage.pop_back();
+			i = 0;
+		} else {
+			i++;
+		}
+	}
+	damage.push_back(rect);
+}
+
+void RetainedUI::composite(const SDL_Rect& region) {
+	SDL_BlendMode previousBlendMode;
+	SDL_GetRenderDrawBlendMode(renderer, &previousBlendMode);
+	SDL_RenderSetClipRect(renderer, &region);
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+	SDL_SetRenderDrawColor(renderer, background.r, background.g, background.b, background.a);
+	SDL_RenderFillRect(renderer, &region);
+	for (const auto& widget : widgets) {
+		if (widget.visible && widget.cache && SDL_HasIntersection(&widget.rect, &region)) {
+			SDL_RenderCopy(renderer, widget.cache, nullptr, &widget.rect);
+		}
+	}
+	SDL_SetRenderDrawBlendMode(renderer, previousBlendMode);
+	numComposited++;
+}
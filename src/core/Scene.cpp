@@ -0,0 +1,124 @@
+#include <core/Scene.h>
+#include <core/AssetPack.h>
+#include <string.h>
+
+Scene::Scene() {
+	data = nullptr;
+	header = nullptr;
+	textures = nullptr;
+	layers = nullptr;
+	entities = nullptr;
+	colliders = nullptr;
+	strings = nullptr;
+}
+
+bool Scene::open(std::string path) {
+	close();
+	size_t size = 0;
+	if (!AssetPack::findMounted(path, &data, &size)) {
+		if (!file.open(path, false)) {
+			return false;
+		}
+		data = file.getData();
+		size = static_cast<size_t>(file.getSize());
+	}
+	header = reinterpret_cast<const SceneHeader*>(data);
+	if (size < sizeof(SceneHeader) || header->magic != SCENE_MAGIC || header->version != SCENE_VERSION) {
+		SDL_SetError("\"%s\" is not a compiled scene", path.c_str());
+		close();
+		return false;
+	}
+	if (header->size > size || !validate()) {
+		SDL_SetError("Scene \"%s\" is truncated or corrupt", path.c_str());
+		close();
+		return false;
+	}
+	textures = reinterpret_cast<const SceneTexture*>(data + header->texturesOffset);
+	layers = reinterpret_cast<const SceneLayer*>(data + header->layersOffset);
+	entities = reinterpret_cast<const SceneEntity*>(data + header->entitiesOffset);
+	colliders = reinterpret_cast<const SceneCollider*>(data + header->collidersOffset);
+	strings = reinterpret_cast<const char*>(data + header->stringsOffset);
+	return true;
+}
+
+void Scene::close() {
+	file.close();
+	data = nullptr;
+	header = nullptr;
+	textures = nullptr;
+	layers = nullptr;
+	entities = nullptr;
+	colliders = nullptr;
+	strings = nullptr;
+}
+
+Uint32 Scene::getNumTextures() {
+	return header ? header->numTextures : 0;
+}
+
+Uint32 Scene::getNumLayers() {
+	return header ? header->numLayers : 0;
+}
+
+Uint32 Scene::getNumEntities() {
+	return header ? header->numEntities : 0;
+}
+
+Uint32 Scene::getNumColliders() {
+	return header ? header->numColliders : 0;
+}
+
+const SceneTexture* Scene::getTexture(Uint32 index) {
+	return index < getNumTextures() ? &textures[index] : nullptr;
+}
+
+const SceneLayer* Scene::getLayer(Uint32 index) {
+	return index < getNumLayers() ? &layers[index] : nullptr;
+}
+
+const SceneEntity* Scene::getEntity(Uint32 index) {
+	return index < getNumEntities() ? &entities[index] : nullptr;
+}
+
+const SceneCollider* Scene::getCollider(Uint32 index) {
+	return index < getNumColliders() ? &colliders[index] : nullptr;
+}
+
+const char* Scene::getString(Uint32 offset) {
+	return offset < header->size - header->stringsOffset ? strings + offset : "";
+}
+
+const SceneLayer* Scene::findLayer(std::string name) {
+	for (Uint32 i = 0; i < getNumLayers(); i++) {
+		if (name == getString(layers[i].nameOffset)) {
+			return &layers[i];
+		}
+	}
+	return nullptr;
+}
+
+const SceneEntity* Scene::findEntity(std::string name) {
+	for (Uint32 i = 0; i < getNumEntities(); i++) {
+		if (name == getString(entities[i].nameOffset)) {
+			return &entities[i];
+		}
+	}
+	return nullptr;
+}
+
+bool Scene::validate() {
+	auto fits = [this](Uint32 offset, Uint32 count, size_t elementSize) {
+		return offset % 4 == 0 && offset >= sizeof(SceneHeader) && offset <= header->size && count <= (header->size - offset) / elementSize;
+	};
+	if (!fits(header->texturesOffset, header->numTextures, sizeof(SceneTexture)) ||
+		!fits(header->layersOffset, header->numLayers, sizeof(SceneLayer)) ||
+		!fits(header->entitiesOffset, header->numEntities, sizeof(SceneEntity)) ||
+		!fits(header->collidersOffset, header->numColliders, sizeof(SceneCollider)) ||
+		header->stringsOffset >= header->size) {
+		return false;
+	}
+	// Only the table bounds are checked here, so opening does not depend on
+	// the scene size. References between records are checked by the getters.
+	const char* stringTable = reinterpret_cast<const char*>(data + header->stringsOffset);
+	return stringTable[header->size - header->stringsOffset - 1] == '\0';
+}
@@ -0,0 +1,434 @@
+#include <core/SurfaceBlitter.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SURFACE_BLITTER_X86
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+#endif
+
+bool SurfaceBlitter::selected = false;
+BlitPath SurfaceBlitter::path = BLIT_PATH_SCALAR;
+ColorKeyRowFunction SurfaceBlitter::colorKeyRow = nullptr;
+BlendRowFunction SurfaceBlitter::blendRow = nullptr;
+NearestRowFunction SurfaceBlitter::nearestRow = nullptr;
+BilinearRowFunction SurfaceBlitter::bilinearRow = nullptr;
+
+namespace {
+
+inline Uint32 divide255(Uint32 value) {
+	value += 128;
+	return (value + (value >> 8)) >> 8;
+}
+
+void colorKeyRowScalar(const Uint32* source, Uint32* destination, int count, Uint32 key, Uint32 rgbMask) {
+	for (int i = 0; i < count; i++) {
+		if ((source[i] & rgbMask) != key) {
+			destination[i] = source[i];
+		}
+	}
+}
+
+void blendRowScalar(const Uint32* source, Uint32* destination, int count, int alphaShift) {
+	Uint32 alphaLane = 0xFFu << alphaShift;
+	for (int i = 0; i < count; i++) {
+		Uint32 alpha = (source[i] >> alphaShift) & 0xFF;
+		if (alpha == 0) {
+			continue;
+		}
+		Uint32 sourcePixel = source[i] | alphaLane;
+		if (alpha == 0xFF) {
+			destination[i] = sourcePixel;
+			continue;
+		}
+		Uint32 destinationPixel = destination[i];
+		Uint32 result = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			Uint32 s = (sourcePixel >> shift) & 0xFF;
+			Uint32 d = (destinationPixel >> shift) & 0xFF;
+			result |= divide255(s * alpha + d * (255 - alpha)) << shift;
+		}
+		destination[i] = result;
+	}
+}
+
+void nearestRowScalar(const Uint32* source, Uint32* destination, const int* columns, int count) {
+	for (int i = 0; i < count; i++) {
+		destination[i] = source[columns[i]];
+	}
+}
+
+void bilinearRowScalar(const Uint32* top, const Uint32* bottom, Uint32* destination, const int* columns, const int* weights, int weightY, int count) {
+	for (int i = 0; i < count; i++) {
+		int x = columns[i];
+		Uint32 weightX = weights[i];
+		Uint32 result = 0;
+		for (int shift = 0; shift < 32; shift += 8) {
+			Uint32 upper = (((top[x] >> shift) & 0xFF) * (256 - weightX) + ((top[x + 1] >> shift) & 0xFF) * weightX) >> 8;
+			Uint32 lower = (((bottom[x] >> shift) & 0xFF) * (256 - weightX) + ((bottom[x + 1] >> shift) & 0xFF) * weightX) >> 8;
+			result |= ((upper * (256 - weightY) + lower * weightY) >> 8) << shift;
+		}
+		destination[i] = result;
+	}
+}
+
+#ifdef SURFACE_BLITTER_X86
+
+TARGET_SSE2 void colorKeyRowSSE2(const Uint32* source, Uint32* destination, int count, Uint32 key, Uint32 rgbMask) {
+	__m128i keyVector = _mm_set1_epi32(static_cast<int>(key));
+	__m128i maskVector = _mm_set1_epi32(static_cast<int>(rgbMask));
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + i));
+		__m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(s, maskVector), keyVector);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_or_si128(_mm_and_si128(transparent, d), _mm_andnot_si128(transparent, s)));
+	}
+	colorKeyRowScalar(source + i, destination + i, count - i, key, rgbMask);
+}
+
+TARGET_SSE2 inline __m128i blendHalfSSE2(__m128i s, __m128i d, __m128i a) {
+	const __m128i c128 = _mm_set1_epi16(128);
+	const __m128i c255 = _mm_set1_epi16(255);
+	__m128i x = _mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(d, _mm_sub_epi16(c255, a)));
+	x = _mm_add_epi16(x, c128);
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+TARGET_SSE2 void blendRowSSE2(const Uint32* source, Uint32* destination, int count, int alphaShift) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaLane = _mm_set1_epi32(static_cast<int>(0xFFu << alphaShift));
+	const __m128i low = _mm_set1_epi32(0xFF);
+	const __m128i shift = _mm_cvtsi32_si128(alphaShift);
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(destination + i));
+		__m128i a = _mm_and_si128(_mm_srl_epi32(s, shift), low);
+		a = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+		a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+		s = _mm_or_si128(s, alphaLane);
+		__m128i lowHalf = blendHalfSSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(a, zero));
+		__m128i highHalf = blendHalfSSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(a, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(lowHalf, highHalf));
+	}
+	blendRowScalar(source + i, destination + i, count - i, alphaShift);
+}
+
+TARGET_SSE2 void bilinearRowSSE2(const Uint32* top, const Uint32* bottom, Uint32* destination, const int* columns, const int* weights, int weightY, int count) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i verticalWeights = _mm_set_epi16(weightY, weightY, weightY, weightY, 256 - weightY, 256 - weightY, 256 - weightY, 256 - weightY);
+	for (int i = 0; i < count; i++) {
+		int x = columns[i];
+		int weightX = weights[i];
+		__m128i horizontalWeights = _mm_set_epi16(weightX, weightX, weightX, weightX, 256 - weightX, 256 - weightX, 256 - weightX, 256 - weightX);
+		__m128i upper = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(top + x)), zero);
+		__m128i lower = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(bottom + x)), zero);
+		upper = _mm_mullo_epi16(upper, horizontalWeights);
+		lower = _mm_mullo_epi16(lower, horizontalWeights);
+		upper = _mm_srli_epi16(_mm_add_epi16(upper, _mm_srli_si128(upper, 8)), 8);
+		lower = _mm_srli_epi16(_mm_add_epi16(lower, _mm_srli_si128(lower, 8)), 8);
+		__m128i blended = _mm_mullo_epi16(_mm_unpacklo_epi64(upper, lower), verticalWeights);
+		blended = _mm_srli_epi16(_mm_add_epi16(blended, _mm_srli_si128(blended, 8)), 8);
+		destination[i] = static_cast<Uint32>(_mm_cvtsi128_si32(_mm_packus_epi16(blended, zero)));
+	}
+}
+
+TARGET_AVX2 void colorKeyRowAVX2(const Uint32* source, Uint32* destination, int count, Uint32 key, Uint32 rgbMask) {
+	__m256i keyVector = _mm256_set1_epi32(static_cast<int>(key));
+	__m256i maskVector = _mm256_set1_epi32(static_cast<int>(rgbMask));
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+		__m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(destination + i));
+		__m256i transparent = _mm256_cmpeq_epi32(_mm256_and_si256(s, maskVector), keyVector);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_blendv_epi8(s, d, transparent));
+	}
+	colorKeyRowScalar(source + i, destination + i, count - i, key, rgbMask);
+}
+
+TARGET_AVX2 inline __m256i blendHalfAVX2(__m256i s, __m256i d, __m256i a) {
+	const __m256i c128 = _mm256_set1_epi16(128);
+	const __m256i c255 = _mm256_set1_epi16(255);
+	__m256i x = _mm256_add_epi16(_mm256_mullo_epi16(s, a), _mm256_mullo_epi16(d, _mm256_sub_epi16(c255, a)));
+	x = _mm256_add_epi16(x, c128);
+	return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+TARGET_AVX2 void blendRowAVX2(const Uint32* source, Uint32* destination, int count, int alphaShift) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i alphaLane = _mm256_set1_epi32(static_cast<int>(0xFFu << alphaShift));
+	const __m256i low = _mm256_set1_epi32(0xFF);
+	const __m128i shift = _mm_cvtsi32_si128(alphaShift);
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+		__m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(destination + i));
+		__m256i a = _mm256_and_si256(_mm256_srl_epi32(s, shift), low);
+		a = _mm256_or_si256(a, _mm256_slli_epi32(a, 8));
+		a = _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+		s = _mm256_or_si256(s, alphaLane);
+		__m256i lowHalf = blendHalfAVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(a, zero));
+		__m256i highHalf = blendHalfAVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(a, zero));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_packus_epi16(lowHalf, highHalf));
+	}
+	blendRowScalar(source + i, destination + i, count - i, alphaShift);
+}
+
+TARGET_AVX2 void nearestRowAVX2(const Uint32* source, Uint32* destination, const int* columns, int count) {
+	const int* pixels = reinterpret_cast<const int*>(source);
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(columns + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_i32gather_epi32(pixels, indices, 4));
+	}
+	nearestRowScalar(source, destination + i, columns + i, count - i);
+}
+
+#endif
+
+bool clipSourceRect(SDL_Surface* source, const SDL_Rect* sourceRect, SDL_Rect& rect) {
+	SDL_Rect bounds{0, 0, source->w, source->h};
+	rect = sourceRect ? *sourceRect : bounds;
+	SDL_Rect clipped;
+	return SDL_IntersectRect(&rect, &bounds, &clipped) && SDL_RectEquals(&clipped, &rect);
+}
+
+}
+
+int SurfaceBlitter::blit(SDL_Surface* source, const SDL_Rect* sourceRect, SDL_Surface* destination, SDL_Rect* destinationRect) {
+	if (getPath() != BLIT_PATH_SDL && isCompatible(source, destination) && !hasModulation(source)) {
+		Uint32 key;
+		bool keyed = SDL_GetColorKey(source, &key) == 0;
+		SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+		SDL_GetSurfaceBlendMode(source, &blendMode);
+		bool blended = blendMode == SDL_BLENDMODE_BLEND && source->format->Amask != 0;
+		bool supported = (blendMode == SDL_BLENDMODE_NONE || blendMode == SDL_BLENDMODE_BLEND) && !(keyed && blended);
+		Operation operation = keyed ? OPERATION_COLOR_KEY : blended ? OPERATION_BLEND : OPERATION_COPY;
+		if (supported && blitRows(operation, source, sourceRect, destination, destinationRect)) {
+			return 0;
+		}
+	}
+	return SDL_BlitSurface(source, sourceRect, destination, destinationRect);
+}
+
+int SurfaceBlitter::blitScaled(SDL_Surface* source, const SDL_Rect* sourceRect, SDL_Surface* destination, SDL_Rect* destinationRect, bool smooth) {
+	if (getPath() != BLIT_PATH_SDL && isCompatible(source, destination) && !hasModulation(source)) {
+		Uint32 key;
+		SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+		SDL_GetSurfaceBlendMode(source, &blendMode);
+		bool opaque = SDL_GetColorKey(source, &key) != 0 && (blendMode == SDL_BLENDMODE_NONE || source->format->Amask == 0);
+		if (opaque && scale(smooth, source, sourceRect, destination, destinationRect)) {
+			return 0;
+		}
+	}
+	return SDL_BlitScaled(source, sourceRect, destination, destinationRect);
+}
+
+void SurfaceBlitter::setPath(BlitPath path) {
+#ifdef SURFACE_BLITTER_X86
+	if (path == BLIT_PATH_AVX2 && !SDL_HasAVX2()) {
+		path = BLIT_PATH_SSE2;
+	}
+	if (path == BLIT_PATH_SSE2 && !SDL_HasSSE2()) {
+		path = BLIT_PATH_SCALAR;
+	}
+#else
+	path = path == BLIT_PATH_SDL ? BLIT_PATH_SDL : BLIT_PATH_SCALAR;
+#endif
+	SurfaceBlitter::path = path;
+	colorKeyRow = colorKeyRowScalar;
+	blendRow = blendRowScalar;
+	nearestRow = nearestRowScalar;
+	bilinearRow = bilinearRowScalar;
+#ifdef SURFACE_BLITTER_X86
+	if (path >= BLIT_PATH_SSE2) {
+		colorKeyRow = colorKeyRowSSE2;
+		blendRow = blendRowSSE2;
+		bilinearRow = bilinearRowSSE2;
+	}
+	if (path >= BLIT_PATH_AVX2) {
+		colorKeyRow = colorKeyRowAVX2;
+		blendRow = blendRowAVX2;
+		nearestRow = nearestRowAVX2;
+	}
+#endif
+}
+
+BlitPath SurfaceBlitter::getPath() {
+	selectPath();
+	return path;
+}
+
+const char* SurfaceBlitter::getPathName() {
+	switch (getPath()) {
+		case BLIT_PATH_AVX2: {
+			return "AVX2";
+		}
+		case BLIT_PATH_SSE2: {
+			return "SSE2";
+		}
+		case BLIT_PATH_SDL: {
+			return "SDL";
+		}
+		default: {
+			return "scalar";
+		}
+	}
+}
+
+void SurfaceBlitter::selectPath() {
+	if (selected) {
+		return;
+	}
+	selected = true;
+	BlitPath requested = BLIT_PATH_AVX2;
+	const char* value = SDL_getenv(SURFACE_BLITTER_VARIABLE);
+	if (value) {
+		if (SDL_strcasecmp(value, "sdl") == 0 || SDL_strcmp(value, "0") == 0) {
+			requested = BLIT_PATH_SDL;
+		} else if (SDL_strcasecmp(value, "scalar") == 0) {
+			requested = BLIT_PATH_SCALAR;
+		} else if (SDL_strcasecmp(value, "sse2") == 0) {
+			requested = BLIT_PATH_SSE2;
+		} else if (SDL_strcasecmp(value, "avx2") != 0) {
+			printf("Warning: Unknown %s value \"%s\", using the fastest blitters!\n", SURFACE_BLITTER_VARIABLE, value);
+		}
+	}
+	setPath(requested);
+}
+
+bool SurfaceBlitter::isCompatible(SDL_Surface* source, SDL_Surface* destination) {
+	if (!source || !destination || SDL_MUSTLOCK(source) || SDL_MUSTLOCK(destination)) {
+		return false;
+	}
+	SDL_PixelFormat* sourceFormat = source->format;
+	SDL_PixelFormat* destinationFormat = destination->format;
+	// The kernels copy the fourth byte as it is. SDL writes opaque alpha when
+	// the source has none, so that case is left to SDL unless the destination
+	// ignores alpha too.
+	bool sameAlpha = sourceFormat->Amask == destinationFormat->Amask || destinationFormat->Amask == 0;
+	return sourceFormat->BytesPerPixel == 4 && destinationFormat->BytesPerPixel == 4 && sameAlpha &&
+		sourceFormat->Rmask == destinationFormat->Rmask && sourceFormat->Gmask == destinationFormat->Gmask && sourceFormat->Bmask == destinationFormat->Bmask;
+}
+
+bool SurfaceBlitter::hasModulation(SDL_Surface* source) {
+	Uint8 r = 0xFF, g = 0xFF, b = 0xFF, a = 0xFF;
+	SDL_GetSurfaceColorMod(source, &r, &g, &b);
+	SDL_GetSurfaceAlphaMod(source, &a);
+	return r != 0xFF || g != 0xFF || b != 0xFF || a != 0xFF;
+}
+
+bool SurfaceBlitter::blitRows(Operation operation, SDL_Surface* source, const SDL_Rect* sourceRect, SDL_Surface* destination, SDL_Rect* destinationRect) {
+	selectPath();
+	SDL_Rect from;
+	if (!clipSourceRect(source, sourceRect, from)) {
+		return false;
+	}
+	SDL_Rect to{destinationRect ? destinationRect->x : 0, destinationRect ? destinationRect->y : 0, from.w, from.h};
+	SDL_Rect clipped;
+	if (!SDL_IntersectRect(&to, &destination->clip_rect, &clipped)) {
+		if (destinationRect) {
+			destinationRect->w = 0;
+			destinationRect->h = 0;
+		}
+		return true;
+	}
+	// Like SDL_BlitSurface, the caller gets back the area that was drawn.
+	if (destinationRect) {
+		*destinationRect = clipped;
+	}
+	from.x += clipped.x - to.x;
+	from.y += clipped.y - to.y;
+
+	Uint32 key = 0;
+	Uint32 rgbMask = ~source->format->Amask;
+	if (operation == OPERATION_COLOR_KEY) {
+		SDL_GetColorKey(source, &key);
+		key &= rgbMask;
+	}
+	int alphaShift = source->format->Ashift;
+	for (int y = 0; y < clipped.h; y++) {
+		const Uint32* sourceRow = reinterpret_cast<const Uint32*>(static_cast<const Uint8*>(source->pixels) + (from.y + y) * source->pitch) + from.x;
+		Uint32* destinationRow = reinterpret_cast<Uint32*>(static_cast<Uint8*>(destination->pixels) + (clipped.y + y) * destination->pitch) + clipped.x;
+		switch (operation) {
+			case OPERATION_COPY: {
+				memmove(destinationRow, sourceRow, clipped.w * sizeof(Uint32));
+				break;
+			}
+			case OPERATION_COLOR_KEY: {
+				colorKeyRow(sourceRow, destinationRow, clipped.w, key, rgbMask);
+				break;
+			}
+			case OPERATION_BLEND: {
+				blendRow(sourceRow, destinationRow, clipped.w, alphaShift);
+				break;
+			}
+		}
+	}
+	return true;
+}
+
+bool SurfaceBlitter::scale(bool smooth, SDL_Surface* source, const SDL_Rect* sourceRect, SDL_Surface* destination, const SDL_Rect* destinationRect) {
+	selectPath();
+	SDL_Rect from;
+	if (!clipSourceRect(source, sourceRect, from) || from.w <= 0 || from.h <= 0) {
+		return false;
+	}
+	SDL_Rect to = destinationRect ? *destinationRect : SDL_Rect{0, 0, destination->w, destination->h};
+	SDL_Rect clipped;
+	if (to.w <= 0 || to.h <= 0 || !SDL_IntersectRect(&to, &destination->clip_rect, &clipped)) {
+		return true;
+	}
+	smooth = smooth && from.w >= 2 && from.h >= 2;
+
+	std::vector<int> columns(clipped.w);
+	std::vector<int> weights(smooth ? clipped.w : 0);
+	for (int i = 0; i < clipped.w; i++) {
+		Sint64 x = clipped.x - to.x + i;
+		if (smooth) {
+			Sint64 position = SDL_max((2 * x + 1) * from.w * 256 / (2 * to.w) - 128, 0);
+			int column = static_cast<int>(position >> 8);
+			int weight = static_cast<int>(position & 0xFF);
+			if (column >= from.w - 1) {
+				column = from.w - 2;
+				weight = 256;
+			}
+			columns[i] = from.x + column;
+			weights[i] = weight;
+		} else {
+			columns[i] = from.x + static_cast<int>(SDL_min((2 * x + 1) * from.w / (2 * to.w), static_cast<Sint64>(from.w - 1)));
+		}
+	}
+
+	const Uint8* sourcePixels = static_cast<const Uint8*>(source->pixels);
+	for (int i = 0; i < clipped.h; i++) {
+		Sint64 y = clipped.y - to.y + i;
+		Uint32* destinationRow = reinterpret_cast<Uint32*>(static_cast<Uint8*>(destination->pixels) + (clipped.y + i) * destination->pitch) + clipped.x;
+		if (smooth) {
+			Sint64 position = SDL_max((2 * y + 1) * from.h * 256 / (2 * to.h) - 128, 0);
+			int row = static_cast<int>(position >> 8);
+			int weight = static_cast<int>(position & 0xFF);
+			if (row >= from.h - 1) {
+				row = from.h - 2;
+				weight = 256;
+			}
+			const Uint32* top = reinterpret_cast<const Uint32*>(sourcePixels + (from.y + row) * source->pitch);
+			const Uint32* bottom = reinterpret_cast<const Uint32*>(sourcePixels + (from.y + row + 1) * source->pitch);
+			bilinearRow(top, bottom, destinationRow, columns.data(), weights.data(), weight, clipped.w);
+		} else {
+			int row = static_cast<int>(SDL_min((2 * y + 1) * from.h / (2 * to.h), static_cast<Sint64>(from.h - 1)));
+			const Uint32* sourceRow = reinterpret_cast<const Uint32*>(sourcePixels + (from.y + row) * source->pitch);
+			nearestRow(sourceRow, destinationRow, columns.data(), clipped.w);
+		}
+	}
+	return true;
+}
@@ -0,0 +1,205 @@
+#include <core/SurfaceCompositor.h>
+#include <core/SurfaceBlitter.h>
+#include <stdio.h>
+#include <algorithm>
+
+SurfaceCompositor::SurfaceCompositor() {
+	window = nullptr;
+	screenSurface = nullptr;
+	pushAll = false;
+	bytesLastFrame = 0;
+	totalBytes = 0;
+	numFrames = 0;
+}
+
+bool SurfaceCompositor::init(SDL_Window* window) {
+	this->window = window;
+	screenSurface = SDL_GetWindowSurface(window);
+	operations.clear();
+	previousOperations.clear();
+	changedSurfaces.clear();
+	damage.clear();
+	invalidate();
+	if (!screenSurface) {
+		return false;
+	}
+	printf("Blitting to the window surface with the %s blitters!\n", SurfaceBlitter::getPathName());
+	return true;
+}
+
+void SurfaceCompositor::blit(SDL_Surface* source, const SDL_Rect* sourceRect, const SDL_Rect* destinationRect) {
+	record(OPERATION_BLIT, source, sourceRect, destinationRect, 0);
+}
+
+void SurfaceCompositor::blitScaled(SDL_Surface* source, const SDL_Rect* sourceRect, const SDL_Rect* destinationRect) {
+	record(OPERATION_BLIT_SCALED, source, sourceRect, destinationRect, 0);
+}
+
+void SurfaceCompositor::fill(const SDL_Rect* rect, Uint32 color) {
+	record(OPERATION_FILL, nullptr, nullptr, rect, color);
+}
+
+void SurfaceCompositor::invalidate(const SDL_Rect* rect) {
+	if (!screenSurface) {
+		return;
+	}
+	addDamage(rect ? *rect : SDL_Rect{0, 0, screenSurface->w, screenSurface->h});
+}
+
+void SurfaceCompositor::invalidateSurface(SDL_Surface* source) {
+	changedSurfaces.push_back(source);
+}
+
+void SurfaceCompositor::handleEvent(SDL_Event& event) {
+	if (event.type != SDL_WINDOWEVENT || event.window.windowID != SDL_GetWindowID(window)) {
+		return;
+	}
+	if (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+		screenSurface = SDL_GetWindowSurface(window);
+		previousOperations.clear();
+		invalidate();
+	} else if (event.window.event == SDL_WINDOWEVENT_EXPOSED) {
+		pushAll = true;
+	}
+}
+
+bool SurfaceCompositor::present() {
+	if (!screenSurface) {
+		return false;
+	}
+	size_t numOperations = std::max(operations.size(), previousOperations.size());
+	for (size_t i = 0; i < numOperations; i++) {
+		const Operation* current = i < operations.size() ? &operations[i] : nullptr;
+		const Operation* previous = i < previousOperations.size() ? &previousOperations[i] : nullptr;
+		if (current && isChanged(*current, previous)) {
+			addDamage(current->destinationRect);
+		}
+		if (previous && (!current || isChanged(*current, previous))) {
+			addDamage(previous->destinationRect);
+		}
+	}
+	for (const auto& rect : damage) {
+		SDL_SetClipRect(screenSurface, &rect);
+		for (auto& operation : operations) {
+			if (SDL_HasIntersection(&operation.destinationRect, &rect)) {
+				execute(operation);
+			}
+		}
+	}
+	SDL_SetClipRect(screenSurface, nullptr);
+
+	bool success = true;
+	int bytesPerPixel = screenSurface->format->BytesPerPixel;
+	bytesLastFrame = 0;
+	if (pushAll) {
+		success = SDL_UpdateWindowSurface(window) == 0;
+		bytesLastFrame = static_cast<Uint64>(screenSurface->w) * screenSurface->h * bytesPerPixel;
+	} else if (!damage.empty()) {
+		success = SDL_UpdateWindowSurfaceRects(window, damage.data(), static_cast<int>(damage.size())) == 0;
+		for (const auto& rect : damage) {
+			bytesLastFrame += static_cast<Uint64>(rect.w) * rect.h * bytesPerPixel;
+		}
+	}
+	totalBytes += bytesLastFrame;
+	numFrames++;
+	pushAll = false;
+	damage.clear();
+	changedSurfaces.clear();
+	previousOperations.swap(operations);
+	operations.clear();
+	return success;
+}
+
+SDL_Surface* SurfaceCompositor::getSurface() {
+	return screenSurface;
+}
+
+Uint64 SurfaceCompositor::getBytesLastFrame() {
+	return bytesLastFrame;
+}
+
+Uint64 SurfaceCompositor::getTotalBytes() {
+	return totalBytes;
+}
+
+Uint32 SurfaceCompositor::getNumFrames() {
+	return numFrames;
+}
+
+void SurfaceCompositor::printStatistics() {
+	if (numFrames == 0 || !screenSurface) {
+		return;
+	}
+	Uint64 fullFrameBytes = static_cast<Uint64>(screenSurface->w) * screenSurface->h * screenSurface->format->BytesPerPixel;
+	double bytesPerFrame = static_cast<double>(totalBytes) / numFrames;
+	printf("Presented %u frames, %llu bytes pushed (%.0f bytes/frame, %.2f%% of full-surface updates)!\n", numFrames, static_cast<unsigned long long>(totalBytes), bytesPerFrame, 100.0 * bytesPerFrame / fullFrameBytes);
+}
+
+void SurfaceCompositor::record(OperationType type, SDL_Surface* source, const SDL_Rect* sourceRect, const SDL_Rect* destinationRect, Uint32 color) {
+	if (!screenSurface) {
+		return;
+	}
+	Operation operation;
+	operation.type = type;
+	operation.source = source;
+	operation.color = color;
+	operation.sourceRect = sourceRect ? *sourceRect : source ? SDL_Rect{0, 0, source->w, source->h} : SDL_Rect{0, 0, 0, 0};
+	if (destinationRect) {
+		operation.destinationRect = *destinationRect;
+	} else {
+		operation.destinationRect = SDL_Rect{0, 0, screenSurface->w, screenSurface->h};
+	}
+	if (type == OPERATION_BLIT) {
+		operation.destinationRect.w = operation.sourceRect.w;
+		operation.destinationRect.h = operation.sourceRect.h;
+	}
+	SDL_Rect bounds{0, 0, screenSurface->w, screenSurface->h};
+	if (!SDL_IntersectRect(&operation.destinationRect, &bounds, &bounds)) {
+		return;
+	}
+	operations.push_back(operation);
+}
+
+void SurfaceCompositor::execute(Operation& operation) {
+	SDL_Rect destination = operation.destinationRect;
+	switch (operation.type) {
+		case OPERATION_BLIT: {
+			SurfaceBlitter::blit(operation.source, &operation.sourceRect, screenSurface, &destination);
+			break;
+		}
+		case OPERATION_BLIT_SCALED: {
+			SurfaceBlitter::blitScaled(operation.source, &operation.sourceRect, screenSurface, &destination);
+			break;
+		}
+		case OPERATION_FILL: {
+			SDL_FillRect(screenSurface, &destination, operation.color);
+			break;
+		}
+	}
+}
+
+bool SurfaceCompositor::isChanged(const Operation& operation, const Operation* previous) {
+	if (!previous || operation.type != previous->type || operation.source != previous->source || operation.color != previous->color ||
+		!SDL_RectEquals(&operation.sourceRect, &previous->sourceRect) || !SDL_RectEquals(&operation.destinationRect, &previous->destinationRect)) {
+		return true;
+	}
+	return operation.source && std::find(changedSurfaces.begin(), changedSurfaces.end(), operation.source) != changedSurfaces.end();
+}
+
+void SurfaceCompositor::addDamage(SDL_Rect rect) {
+	SDL_Rect bounds{0, 0, screenSurface->w, screenSurface->h};
+	if (!SDL_IntersectRect(&rect, &bounds, &rect)) {
+		return;
+	}
+	for (size_t i = 0; i < damage.size();) {
+		if (SDL_HasIntersection(&damage[i], &rect)) {
+			SDL_UnionRect(&damage[i], &rect, &rect);
+			damage[i] = damage.back();
+			damage.pop_back();
+			i = 0;
+		} else {
+			i++;
+		}
+	}
+	damage.push_back(rect);
+}
@@ -1,8 +1,14 @@
 #include <core/Texture.h>
+#include <core/AssetPack.h>
+#include <core/CookedTexture.h>
+#include <core/TiledRenderer.h>
 #include <stdio.h>
 
 Texture::Texture() {
 	texture = nullptr;
+	surface = nullptr;
+	colorMod = SDL_Color{0xFF, 0xFF, 0xFF, 0xFF};
+	blendMode = SDL_BLENDMODE_NONE;
 	width = 0;
 	height = 0;
 }
@@ -13,64 +19,109 @@ Texture::~Texture() {
 
 bool Texture::loadFromFile(SDL_Renderer* renderer, std::string path) {
 	free();
-	SDL_Texture* newTexture = nullptr;
-	SDL_Surface* loadedSurface = IMG_Load(path.c_str());
+	SDL_RWops* cookedFile = openCooked(renderer, path);
+	if (cookedFile) {
+		if (loadFromCooked(renderer, cookedFile)) {
+			return true;
+		}
+		printf("Warning: Unable to load cooked texture for %s! Error: %s\n", path.c_str(), SDL_GetError());
+	}
+	SDL_Surface* loadedSurface = IMG_Load_RW(AssetPack::openFile(path), 1);
 	if (!loadedSurface) {
 		printf("Unable to load image %s! Error: %s\n", path.c_str(), IMG_GetError());
+		return false;
+	}
+	SDL_SetColorKey(loadedSurface, true, SDL_MapRGB(loadedSurface->format, 0x00, 0xFF, 0xFF));
+	bool success = loadFromSurface(renderer, loadedSurface);
+	if (!success) {
+		printf("Unable to create texture from %s! Error: %s\n", path.c_str(), SDL_GetError());
+	}
+	SDL_FreeSurface(loadedSurface);
+	return success;
+}
+
+bool Texture::loadFromSurface(SDL_Renderer* renderer, SDL_Surface* surface) {
+	free();
+	if (TiledRenderer::find(renderer)) {
+		this->surface = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
 	} else {
-		SDL_SetColorKey(loadedSurface, true, SDL_MapRGB(loadedSurface->format, 0x00, 0xFF, 0xFF));
-		newTexture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
-		if (!newTexture) {
-			printf("Unable to create texture from %s! Error: %s\n", path.c_str(), SDL_GetError());
-		} else {
-			width = loadedSurface->w;
-			height = loadedSurface->h;
-		}
-		SDL_FreeSurface(loadedSurface);
+		texture = SDL_CreateTextureFromSurface(renderer, surface);
+	}
+	if (!texture && !this->surface) {
+		return false;
+	}
+	Uint32 colorKey;
+	blendMode = surface->format->Amask || SDL_GetColorKey(surface, &colorKey) == 0 ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE;
+	width = surface->w;
+	height = surface->h;
+	return true;
+}
+
+bool Texture::loadFromCooked(SDL_Renderer* renderer, SDL_RWops* file) {
+	free();
+	if (!file) {
+		return false;
+	}
+	texture = CookedTexture::load(renderer, file, &width, &height);
+	if (!texture) {
+		return false;
 	}
-	texture = newTexture;
-	return texture != nullptr;
+	blendMode = SDL_BLENDMODE_BLEND;
+	return true;
 }
 
 bool Texture::loadFromRenderedText(SDL_Renderer* renderer, TTF_Font* font, std::string textureText, SDL_Color textColor) {
 	free();
-	SDL_Texture* newTexture = nullptr;
+	bool success = false;
 	SDL_Surface* textSurface = TTF_RenderText_Solid(font, textureText.c_str(), textColor);
 	if (!textSurface) {
 		printf("Unable to render text surface! Error: %s\n", TTF_GetError());
 	} else {
-		newTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-		if (!newTexture) {
+		success = loadFromSurface(renderer, textSurface);
+		if (!success) {
 			printf("Unable to create texture from rendered text! Error: %s\n", SDL_GetError());
-		} else {
-			width = textSurface->w;
-			height = textSurface->h;
 		}
 		SDL_FreeSurface(textSurface);
 	}
-	texture = newTexture;
-	return texture != nullptr;
+	return success;
 }
 
 void Texture::setColor(Uint8 r, Uint8 g, Uint8 b) {
-	SDL_SetTextureColorMod(texture, r, g, b);
+	colorMod.r = r;
+	colorMod.g = g;
+	colorMod.b = b;
+	if (texture) {
+		SDL_SetTextureColorMod(texture, r, g, b);
+	}
 }
 
 void Texture::setBlendMode(SDL_BlendMode blendMode) {
-	SDL_SetTextureBlendMode(texture, blendMode);
+	this->blendMode = blendMode;
+	if (texture) {
+		SDL_SetTextureBlendMode(texture, blendMode);
+	}
 }
 
 void Texture::setAlpha(Uint8 alpha) {
-	SDL_SetTextureAlphaMod(texture, alpha);
+	colorMod.a = alpha;
+	if (texture) {
+		SDL_SetTextureAlphaMod(texture, alpha);
+	}
 }
 
 void Texture::free() {
 	if (texture) {
 		SDL_DestroyTexture(texture);
 		texture = nullptr;
-		width = 0;
-		height = 0;
 	}
+	if (surface) {
+		SDL_FreeSurface(surface);
+		surface = nullptr;
+	}
+	colorMod = SDL_Color{0xFF, 0xFF, 0xFF, 0xFF};
+	blendMode = SDL_BLENDMODE_NONE;
+	width = 0;
+	height = 0;
 }
 
 void Texture::render(SDL_Renderer* renderer, int x, int y, SDL_Rect* clip, double angle, SDL_Point* center, SDL_RendererFlip flip) {
@@ -79,6 +130,10 @@ void Texture::render(SDL_Renderer* renderer, int x, int y, SDL_Rect* clip, doubl
 		renderQuad.w = clip->w;
 		renderQuad.h = clip->h;
 	}
+	if (TiledRenderer* tiled = TiledRenderer::find(renderer)) {
+		tiled->copy(surface, clip, &renderQuad, angle, center, flip, colorMod, blendMode);
+		return;
+	}
 	SDL_RenderCopyEx(renderer, texture, clip, &renderQuad, angle, center, flip);
 }
 
@@ -88,4 +143,13 @@ int Texture::getWidth() {
 
 int Texture::getHeight() {
 	return height;
+}
+
+bool Texture::acceptsCooked(SDL_Renderer* renderer) {
+	// The tiled renderer samples surfaces, so it always decodes the source.
+	return TiledRenderer::find(renderer) == nullptr;
+}
+
+SDL_RWops* Texture::openCooked(SDL_Renderer* renderer, std::string path) {
+	return acceptsCooked(renderer) ? AssetPack::openFile(CookedTexture::getCookedPath(path)) : nullptr;
 }
\ No newline at end of file
@@ -0,0 +1,522 @@
+#include <core/TiledRenderer.h>
+#include <core/JobSystem.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+TiledRenderer* TiledRenderer::active = nullptr;
+
+namespace {
+
+inline Uint32 divide255(Uint32 value) {
+	value += 128;
+	return (value + (value >> 8)) >> 8;
+}
+
+inline Uint32 blendPixel(Uint32 destination, Uint32 r, Uint32 g, Uint32 b, Uint32 a, SDL_BlendMode blendMode) {
+	Uint32 destinationA = destination >> 24;
+	Uint32 destinationR = (destination >> 16) & 0xFF;
+	Uint32 destinationG = (destination >> 8) & 0xFF;
+	Uint32 destinationB = destination & 0xFF;
+	switch (blendMode) {
+		case SDL_BLENDMODE_BLEND: {
+			if (a == 0xFF) {
+				break;
+			}
+			if (a == 0) {
+				return destination;
+			}
+			r = divide255(r * a + destinationR * (0xFF - a));
+			g = divide255(g * a + destinationG * (0xFF - a));
+			b = divide255(b * a + destinationB * (0xFF - a));
+			a = a + divide255(destinationA * (0xFF - a));
+			break;
+		}
+		case SDL_BLENDMODE_ADD: {
+			r = SDL_min(destinationR + divide255(r * a), 0xFFu);
+			g = SDL_min(destinationG + divide255(g * a), 0xFFu);
+			b = SDL_min(destinationB + divide255(b * a), 0xFFu);
+			a = destinationA;
+			break;
+		}
+		case SDL_BLENDMODE_MOD: {
+			r = divide255(r * destinationR);
+			g = divide255(g * destinationG);
+			b = divide255(b * destinationB);
+			a = destinationA;
+			break;
+		}
+		default: {
+			break;
+		}
+	}
+	return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+inline Uint32 shadeTexel(Uint32 destination, Uint32 texel, const SDL_Color& colorMod, bool modulated, SDL_BlendMode blendMode) {
+	Uint32 a = texel >> 24;
+	Uint32 r = (texel >> 16) & 0xFF;
+	Uint32 g = (texel >> 8) & 0xFF;
+	Uint32 b = texel & 0xFF;
+	if (modulated) {
+		r = divide255(r * colorMod.r);
+		g = divide255(g * colorMod.g);
+		b = divide255(b * colorMod.b);
+		a = divide255(a * colorMod.a);
+	}
+	return blendPixel(destination, r, g, b, a, blendMode);
+}
+
+bool isEmpty(const SDL_Rect& rect) {
+	return rect.w <= 0 || rect.h <= 0;
+}
+
+}
+
+TiledRenderer::TiledRenderer() {
+	renderer = nullptr;
+	streamingTexture = nullptr;
+	width = 0;
+	height = 0;
+	numTilesX = 0;
+	numTilesY = 0;
+	drawColor = SDL_Color{0x00, 0x00, 0x00, 0xFF};
+	drawBlendMode = SDL_BLENDMODE_NONE;
+	viewport = SDL_Rect{0, 0, 0, 0};
+	clipRect = SDL_Rect{0, 0, 0, 0};
+	clipEnabled = false;
+	numFrames = 0;
+	rasterTicks = 0;
+}
+
+TiledRenderer::~TiledRenderer() {
+	free();
+}
+
+bool TiledRenderer::init(SDL_Renderer* renderer, int width, int height) {
+	free();
+	streamingTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+	if (!streamingTexture) {
+		printf("Unable to create tiled renderer framebuffer! Error: %s\n", SDL_GetError());
+		return false;
+	}
+	SDL_SetTextureBlendMode(streamingTexture, SDL_BLENDMODE_NONE);
+	this->renderer = renderer;
+	this->width = width;
+	this->height = height;
+	numTilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+	numTilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+	framebuffer.assign(static_cast<size_t>(width) * height, 0xFF000000);
+	tiles.assign(numTilesX * numTilesY, std::vector<int>());
+	SDL_GetRenderDrawColor(renderer, &drawColor.r, &drawColor.g, &drawColor.b, &drawColor.a);
+	SDL_GetRenderDrawBlendMode(renderer, &drawBlendMode);
+	viewport = SDL_Rect{0, 0, width, height};
+	clipEnabled = false;
+	active = this;
+	return true;
+}
+
+void TiledRenderer::free() {
+	if (active == this) {
+		active = nullptr;
+	}
+	if (streamingTexture) {
+		SDL_DestroyTexture(streamingTexture);
+		streamingTexture = nullptr;
+	}
+	renderer = nullptr;
+	commands.clear();
+	tiles.clear();
+	framebuffer.clear();
+}
+
+void TiledRenderer::printStatistics() {
+	if (numFrames > 0) {
+		double milliseconds = static_cast<double>(rasterTicks) * 1000.0 / SDL_GetPerformanceFrequency() / numFrames;
+		printf("Tiled renderer: %d threads, %llu frames, %.3f ms rasterizing per frame\n", getNumThreads(), static_cast<unsigned long long>(numFrames), milliseconds);
+	}
+}
+
+int TiledRenderer::getNumThreads() {
+	return JobSystem::getNumThreads();
+}
+
+void TiledRenderer::copy(SDL_Surface* source, const SDL_Rect* sourceRect, const SDL_Rect* destinationRect, double angle, const SDL_Point* center, SDL_RendererFlip flip, SDL_Color colorMod, SDL_BlendMode blendMode) {
+	if (!source) {
+		return;
+	}
+	TiledCommand command{};
+	command.type = TILED_COMMAND_COPY;
+	command.source = source;
+	SDL_Rect surfaceRect{0, 0, source->w, source->h};
+	SDL_Rect requested = sourceRect ? *sourceRect : surfaceRect;
+	SDL_Rect target = destinationRect ? *destinationRect : SDL_Rect{0, 0, viewport.w, viewport.h};
+	if (isEmpty(requested) || isEmpty(target) || !SDL_IntersectRect(&requested, &surfaceRect, &command.sourceRect)) {
+		return;
+	}
+	// Like SDL_RenderCopy, the part of the source outside the surface is cut off
+	// the destination too, so the visible texels keep their scale and position.
+	SDL_FPoint pivot = center ? SDL_FPoint{static_cast<float>(center->x), static_cast<float>(center->y)} : SDL_FPoint{target.w * 0.5f, target.h * 0.5f};
+	const SDL_Rect& clipped = command.sourceRect;
+	if (!SDL_RectEquals(&clipped, &requested)) {
+		bool flipX = (flip & SDL_FLIP_HORIZONTAL) != 0;
+		bool flipY = (flip & SDL_FLIP_VERTICAL) != 0;
+		Sint64 skipX = flipX ? (requested.x + requested.w) - (clipped.x + clipped.w) : clipped.x - requested.x;
+		Sint64 skipY = flipY ? (requested.y + requested.h) - (clipped.y + clipped.h) : clipped.y - requested.y;
+		int offsetX = static_cast<int>(skipX * target.w / requested.w);
+		int offsetY = static_cast<int>(skipY * target.h / requested.h);
+		target.x += offsetX;
+		target.y += offsetY;
+		target.w = static_cast<int>(static_cast<Sint64>(clipped.w) * target.w / requested.w);
+		target.h = static_cast<int>(static_cast<Sint64>(clipped.h) * target.h / requested.h);
+		pivot.x -= offsetX;
+		pivot.y -= offsetY;
+		if (isEmpty(target)) {
+			return;
+		}
+	}
+	command.destinationRect = SDL_Rect{viewport.x + target.x, viewport.y + target.y, target.w, target.h};
+	command.color = colorMod;
+	command.blendMode = blendMode;
+	command.flip = flip;
+	command.angle = angle;
+	command.center = pivot;
+	const SDL_Rect& rect = command.destinationRect;
+	if (angle == 0.0) {
+		command.bounds = rect;
+	} else {
+		double radians = angle * M_PI / 180.0;
+		double cosine = cos(radians);
+		double sine = sin(radians);
+		double pivotX = rect.x + command.center.x;
+		double pivotY = rect.y + command.center.y;
+		double minX = pivotX, minY = pivotY, maxX = pivotX, maxY = pivotY;
+		for (int corner = 0; corner < 4; corner++) {
+			double x = ((corner & 1) ? rect.w : 0) - command.center.x;
+			double y = ((corner & 2) ? rect.h : 0) - command.center.y;
+			double rotatedX = pivotX + x * cosine - y * sine;
+			double rotatedY = pivotY + x * sine + y * cosine;
+			minX = SDL_min(minX, rotatedX);
+			minY = SDL_min(minY, rotatedY);
+			maxX = SDL_max(maxX, rotatedX);
+			maxY = SDL_max(maxY, rotatedY);
+		}
+		command.bounds.x = static_cast<int>(floor(minX));
+		command.bounds.y = static_cast<int>(floor(minY));
+		command.bounds.w = static_cast<int>(ceil(maxX)) - command.bounds.x;
+		command.bounds.h = static_cast<int>(ceil(maxY)) - command.bounds.y;
+	}
+	record(command);
+}
+
+bool TiledRenderer::shouldEnable(SDL_Renderer* renderer) {
+	const char* value = SDL_getenv(TILED_RENDERER_VARIABLE);
+	if (value) {
+		return SDL_atoi(value) != 0;
+	}
+	SDL_RendererInfo info;
+	return renderer && SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_SOFTWARE);
+}
+
+TiledRenderer* TiledRenderer::find(SDL_Renderer* renderer) {
+	return active && active->renderer == renderer ? active : nullptr;
+}
+
+int TiledRenderer::setDrawColor(SDL_Renderer* renderer, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+	TiledRenderer* tiled = find(renderer);
+	if (!tiled) {
+		return SDL_SetRenderDrawColor(renderer, r, g, b, a);
+	}
+	tiled->drawColor = SDL_Color{r, g, b, a};
+	return 0;
+}
+
+int TiledRenderer::setDrawBlendMode(SDL_Renderer* renderer, SDL_BlendMode blendMode) {
+	TiledRenderer* tiled = find(renderer);
+	if (!tiled) {
+		return SDL_SetRenderDrawBlendMode(renderer, blendMode);
+	}
+	tiled->drawBlendMode = blendMode;
+	return 0;
+}
+
+int TiledRenderer::setViewport(SDL_Renderer* renderer, const SDL_Rect* rect) {
+	TiledRenderer* tiled = find(renderer);
+	if (!tiled) {
+		return SDL_RenderSetViewport(renderer, rect);
+	}
+	tiled->viewport = rect ? *rect : SDL_Rect{0, 0, tiled->width, tiled->height};
+	return 0;
+}
+
+void TiledRenderer::getViewport(SDL_Renderer* renderer, SDL_Rect* rect) {
+	TiledRenderer* tiled = find(renderer);
+	if (!tiled) {
+		SDL_RenderGetViewport(renderer, rect);
+		return;
+	}
+	*rect = tiled->viewport;
+}
+
+int TiledRenderer::setClipRect(SDL_Renderer* renderer, const SDL_Rect* rect) {
+	TiledRenderer* tiled = find(renderer);
+	if (!tiled) {
+		return SDL_RenderSetClipRect(renderer, rect);
+	}
+	tiled->clipEnabled = rect != nullptr;
+	if (rect) {
+		tiled->clipRect = *rect;
+	}
+	return 0;
+}
+
+int TiledRenderer::clear(SDL_Renderer* renderer) {
+	TiledRenderer* tiled = find(renderer);
+	if (!tiled) {
+		return SDL_RenderClear(renderer);
+	}
+	TiledCommand command{};
+	command.type = TILED_COMMAND_FILL;
+	command.bounds = SDL_Rect{0, 0, tiled->width, tiled->height};
+	command.blendMode = SDL_BLENDMODE_NONE;
+	command.color = tiled->drawColor;
+	tiled->commands.push_back(command);
+	return 0;
+}
+
+int TiledRenderer::fillRect(SDL_Renderer* renderer, const SDL_Rect* rect) {
+	TiledRenderer* tiled = find(renderer);
+	if (!tiled) {
+		return SDL_RenderFillRect(renderer, rect);
+	}
+	tiled->recordFill(rect ? *rect : SDL_Rect{0, 0, tiled->viewport.w, tiled->viewport.h});
+	return 0;
+}
+
+int TiledRenderer::drawRect(SDL_Renderer* renderer, const SDL_Rect* rect) {
+	TiledRenderer* tiled = find(renderer);
+	if (!tiled) {
+		return SDL_RenderDrawRect(renderer, rect);
+	}
+	SDL_Rect outline = rect ? *rect : SDL_Rect{0, 0, tiled->viewport.w, tiled->viewport.h};
+	if (outline.w <= 2 || outline.h <= 2) {
+		tiled->recordFill(outline);
+		return 0;
+	}
+	tiled->recordFill(SDL_Rect{outline.x, outline.y, outline.w, 1});
+	tiled->recordFill(SDL_Rect{outline.x, outline.y + outline.h - 1, outline.w, 1});
+	tiled->recordFill(SDL_Rect{outline.x, outline.y + 1, 1, outline.h - 2});
+	tiled->recordFill(SDL_Rect{outline.x + outline.w - 1, outline.y + 1, 1, outline.h - 2});
+	return 0;
+}
+
+int TiledRenderer::drawLine(SDL_Renderer* renderer, int x1, int y1, int x2, int y2) {
+	TiledRenderer* tiled = find(renderer);
+	if (!tiled) {
+		return SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
+	}
+	TiledCommand command{};
+	command.type = TILED_COMMAND_LINE;
+	command.from = SDL_Point{tiled->viewport.x + x1, tiled->viewport.y + y1};
+	command.to = SDL_Point{tiled->viewport.x + x2, tiled->viewport.y + y2};
+	command.bounds.x = SDL_min(command.from.x, command.to.x);
+	command.bounds.y = SDL_min(command.from.y, command.to.y);
+	command.bounds.w = SDL_max(command.from.x, command.to.x) - command.bounds.x + 1;
+	command.bounds.h = SDL_max(command.from.y, command.to.y) - command.bounds.y + 1;
+	command.blendMode = tiled->drawBlendMode;
+	command.color = tiled->drawColor;
+	tiled->record(command);
+	return 0;
+}
+
+int TiledRenderer::drawPoint(SDL_Renderer* renderer, int x, int y) {
+	TiledRenderer* tiled = find(renderer);
+	if (!tiled) {
+		return SDL_RenderDrawPoint(renderer, x, y);
+	}
+	tiled->recordFill(SDL_Rect{x, y, 1, 1});
+	return 0;
+}
+
+void TiledRenderer::present(SDL_Renderer* renderer) {
+	TiledRenderer* tiled = find(renderer);
+	if (!tiled) {
+		SDL_RenderPresent(renderer);
+		return;
+	}
+	tiled->presentFrame();
+}
+
+bool TiledRenderer::getClip(SDL_Rect* clip) {
+	SDL_Rect screen{0, 0, width, height};
+	if (!SDL_IntersectRect(&viewport, &screen, clip)) {
+		return false;
+	}
+	if (clipEnabled) {
+		SDL_Rect rect{viewport.x + clipRect.x, viewport.y + clipRect.y, clipRect.w, clipRect.h};
+		SDL_Rect visible = *clip;
+		return SDL_IntersectRect(&rect, &visible, clip);
+	}
+	return true;
+}
+
+void TiledRenderer::record(TiledCommand& command) {
+	SDL_Rect clip;
+	SDL_Rect bounds = command.bounds;
+	if (getClip(&clip) && SDL_IntersectRect(&bounds, &clip, &command.bounds)) {
+		commands.push_back(command);
+	}
+}
+
+void TiledRenderer::recordFill(const SDL_Rect& rect) {
+	TiledCommand command{};
+	command.type = TILED_COMMAND_FILL;
+	command.bounds = SDL_Rect{viewport.x + rect.x, viewport.y + rect.y, rect.w, rect.h};
+	command.blendMode = drawBlendMode;
+	command.color = drawColor;
+	record(command);
+}
+
+void TiledRenderer::rasterize() {
+	for (auto& tile : tiles) {
+		tile.clear();
+	}
+	for (int i = 0; i < static_cast<int>(commands.size()); i++) {
+		const SDL_Rect& bounds = commands[i].bounds;
+		int firstX = bounds.x / TILE_SIZE;
+		int firstY = bounds.y / TILE_SIZE;
+		int lastX = (bounds.x + bounds.w - 1) / TILE_SIZE;
+		int lastY = (bounds.y + bounds.h - 1) / TILE_SIZE;
+		for (int y = firstY; y <= lastY; y++) {
+			for (int x = firstX; x <= lastX; x++) {
+				tiles[y * numTilesX + x].push_back(i);
+			}
+		}
+	}
+	JobSystem::parallelFor(static_cast<int>(tiles.size()), [this](int begin, int end) {
+		for (int tile = begin; tile < end; tile++) {
+			if (!tiles[tile].empty()) {
+				rasterizeTile(tile);
+			}
+		}
+	}, 1);
+}
+
+void TiledRenderer::rasterizeTile(int tile) {
+	SDL_Rect tileRect{(tile % numTilesX) * TILE_SIZE, (tile / numTilesX) * TILE_SIZE, TILE_SIZE, TILE_SIZE};
+	for (int index : tiles[tile]) {
+		const TiledCommand& command = commands[index];
+		SDL_Rect area;
+		if (!SDL_IntersectRect(&tileRect, &command.bounds, &area)) {
+			continue;
+		}
+		int right = area.x + area.w;
+		int bottom = area.y + area.h;
+		switch (command.type) {
+			case TILED_COMMAND_FILL: {
+				const SDL_Color& color = command.color;
+				bool opaque = command.blendMode == SDL_BLENDMODE_NONE || (command.blendMode == SDL_BLENDMODE_BLEND && color.a == 0xFF);
+				Uint32 pixel = (static_cast<Uint32>(color.a) << 24) | (color.r << 16) | (color.g << 8) | color.b;
+				for (int y = area.y; y < bottom; y++) {
+					Uint32* row = &framebuffer[static_cast<size_t>(y) * width];
+					for (int x = area.x; x < right; x++) {
+						row[x] = opaque ? pixel : blendPixel(row[x], color.r, color.g, color.b, color.a, command.blendMode);
+					}
+				}
+				break;
+			}
+			case TILED_COMMAND_LINE: {
+				int x = command.from.x;
+				int y = command.from.y;
+				int dx = SDL_abs(command.to.x - x);
+				int dy = -SDL_abs(command.to.y - y);
+				int stepX = x < command.to.x ? 1 : -1;
+				int stepY = y < command.to.y ? 1 : -1;
+				int error = dx + dy;
+				const SDL_Color& color = command.color;
+				while (true) {
+					if (x >= area.x && x < right && y >= area.y && y < bottom) {
+						Uint32& pixel = framebuffer[static_cast<size_t>(y) * width + x];
+						pixel = blendPixel(pixel, color.r, color.g, color.b, color.a, command.blendMode);
+					}
+					if (x == command.to.x && y == command.to.y) {
+						break;
+					}
+					int doubled = 2 * error;
+					if (doubled >= dy) {
+						error += dy;
+						x += stepX;
+					}
+					if (doubled <= dx) {
+						error += dx;
+						y += stepY;
+					}
+				}
+				break;
+			}
+			case TILED_COMMAND_COPY: {
+				const SDL_Surface* source = command.source;
+				const SDL_Rect& from = command.sourceRect;
+				const SDL_Rect& to = command.destinationRect;
+				const SDL_Color& colorMod = command.color;
+				bool modulated = colorMod.r != 0xFF || colorMod.g != 0xFF || colorMod.b != 0xFF || colorMod.a != 0xFF;
+				bool flipX = (command.flip & SDL_FLIP_HORIZONTAL) != 0;
+				bool flipY = (command.flip & SDL_FLIP_VERTICAL) != 0;
+				const Uint8* pixels = static_cast<const Uint8*>(source->pixels);
+				if (command.angle == 0.0) {
+					Sint64 stepX = (static_cast<Sint64>(from.w) << 16) / to.w;
+					Sint64 stepY = (static_cast<Sint64>(from.h) << 16) / to.h;
+					for (int y = area.y; y < bottom; y++) {
+						int v = static_cast<int>(((y - to.y) * stepY + stepY / 2) >> 16);
+						v = flipY ? from.h - 1 - v : v;
+						const Uint32* texels = reinterpret_cast<const Uint32*>(pixels + (from.y + v) * source->pitch) + from.x;
+						Uint32* row = &framebuffer[static_cast<size_t>(y) * width];
+						Sint64 position = (area.x - to.x) * stepX + stepX / 2;
+						for (int x = area.x; x < right; x++, position += stepX) {
+							int u = static_cast<int>(position >> 16);
+							row[x] = shadeTexel(row[x], texels[flipX ? from.w - 1 - u : u], colorMod, modulated, command.blendMode);
+						}
+					}
+				} else {
+					double radians = command.angle * M_PI / 180.0;
+					double cosine = cos(radians);
+					double sine = sin(radians);
+					double pivotX = to.x + command.center.x;
+					double pivotY = to.y + command.center.y;
+					double scaleX = static_cast<double>(from.w) / to.w;
+					double scaleY = static_cast<double>(from.h) / to.h;
+					for (int y = area.y; y < bottom; y++) {
+						Uint32* row = &framebuffer[static_cast<size_t>(y) * width];
+						for (int x = area.x; x < right; x++) {
+							double offsetX = x + 0.5 - pivotX;
+							double offsetY = y + 0.5 - pivotY;
+							double localX = offsetX * cosine + offsetY * sine + command.center.x;
+							double localY = -offsetX * sine + offsetY * cosine + command.center.y;
+							if (localX < 0.0 || localY < 0.0 || localX >= to.w || localY >= to.h) {
+								continue;
+							}
+							int u = SDL_min(static_cast<int>(localX * scaleX), from.w - 1);
+							int v = SDL_min(static_cast<int>(localY * scaleY), from.h - 1);
+							u = flipX ? from.w - 1 - u : u;
+							v = flipY ? from.h - 1 - v : v;
+							Uint32 texel = reinterpret_cast<const Uint32*>(pixels + (from.y + v) * source->pitch)[from.x + u];
+							row[x] = shadeTexel(row[x], texel, colorMod, modulated, command.blendMode);
+						}
+					}
+				}
+				break;
+			}
+		}
+	}
+}
+
+void TiledRenderer::presentFrame() {
+	Uint64 start = SDL_GetPerformanceCounter();
+	rasterize();
+	rasterTicks += SDL_GetPerformanceCounter() - start;
+	numFrames++;
+	commands.clear();
+	SDL_UpdateTexture(streamingTexture, nullptr, framebuffer.data(), width * static_cast<int>(sizeof(Uint32)));
+	SDL_RenderCopy(renderer, streamingTexture, nullptr, nullptr);
+	SDL_RenderPresent(renderer);
+}
@@ -0,0 +1,264 @@
+#include <core/VoiceManager.h>
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+
+VoiceManager::VoiceManager() {
+	hearingDistance = 0;
+	listener.x = 0;
+	listener.y = 0;
+	numCulled = 0;
+	numStolen = 0;
+}
+
+bool VoiceManager::init(int numVoices, int distance) {
+	if (Mix_AllocateChannels(numVoices) != numVoices) {
+		printf("Unable to allocate %d mixer channels! Error: %s\n", numVoices, Mix_GetError());
+		return false;
+	}
+	voices.assign(numVoices, -1);
+	candidates.reserve(numVoices);
+	hearingDistance = distance;
+	return true;
+}
+
+int VoiceManager::createEmitter(Mix_Chunk* chunk, int priority, bool looping) {
+	int emitterId = allocateEmitter();
+	SoundEmitter& emitter = emitters[emitterId];
+	emitter.chunk = chunk;
+	emitter.priority = priority;
+	emitter.looping = looping;
+	return emitterId;
+}
+
+void VoiceManager::destroyEmitter(int emitterId) {
+	if (!emitters[emitterId].alive) {
+		return;
+	}
+	stop(emitterId);
+	emitters[emitterId].alive = false;
+	emitters[emitterId].chunk = nullptr;
+	freeEmitters.push_back(emitterId);
+}
+
+void VoiceManager::setEmitterPosition(int emitterId, int x, int y) {
+	emitters[emitterId].posX = x;
+	emitters[emitterId].posY = y;
+}
+
+void VoiceManager::start(int emitterId) {
+	emitters[emitterId].active = true;
+}
+
+void VoiceManager::stop(int emitterId) {
+	SoundEmitter& emitter = emitters[emitterId];
+	if (emitter.channel >= 0) {
+		Mix_HaltChannel(emitter.channel);
+		releaseVoice(emitter.channel);
+	}
+	emitter.active = false;
+}
+
+bool VoiceManager::playAt(Mix_Chunk* chunk, int x, int y, int priority) {
+	int emitterId = allocateEmitter();
+	SoundEmitter& emitter = emitters[emitterId];
+	emitter.chunk = chunk;
+	emitter.posX = x;
+	emitter.posY = y;
+	emitter.priority = priority;
+	emitter.looping = false;
+	Candidate candidate{emitterId, priority, distanceSquared(emitter)};
+	int channel = -1;
+	if (!isAudible(candidate.distanceSquared)) {
+		numCulled++;
+	} else {
+		channel = findVoice(candidate);
+	}
+	emitter.active = true;
+	if (channel < 0 || !assignVoice(emitterId, channel)) {
+		destroyEmitter(emitterId);
+		return false;
+	}
+	return true;
+}
+
+void VoiceManager::setListenerPosition(int x, int y) {
+	listener.x = x;
+	listener.y = y;
+}
+
+void VoiceManager::update() {
+	for (int channel = 0; channel < static_cast<int>(voices.size()); channel++) {
+		int emitterId = voices[channel];
+		if (emitterId >= 0 && !emitters[emitterId].looping && !Mix_Playing(channel)) {
+			releaseVoice(channel);
+			destroyEmitter(emitterId);
+		}
+	}
+
+	candidates.clear();
+	for (int emitterId = 0; emitterId < static_cast<int>(emitters.size()); emitterId++) {
+		SoundEmitter& emitter = emitters[emitterId];
+		if (!emitter.alive || !emitter.active) {
+			continue;
+		}
+		Candidate candidate{emitterId, emitter.priority, distanceSquared(emitter)};
+		if (isAudible(candidate.distanceSquared)) {
+			candidates.push_back(candidate);
+		} else {
+			numCulled++;
+			if (emitter.channel >= 0) {
+				Mix_HaltChannel(emitter.channel);
+				releaseVoice(emitter.channel);
+			}
+			if (!emitter.looping) {
+				destroyEmitter(emitterId);
+			}
+		}
+	}
+
+	auto compare = [this](const Candidate& a, const Candidate& b) {
+		return outranks(a, b);
+	};
+	size_t numSelected = std::min(candidates.size(), voices.size());
+	std::nth_element(candidates.begin(), candidates.begin() + numSelected, candidates.end(), compare);
+
+	for (size_t i = numSelected; i < candidates.size(); i++) {
+		SoundEmitter& emitter = emitters[candidates[i].emitterId];
+		if (emitter.channel >= 0) {
+			Mix_HaltChannel(emitter.channel);
+			releaseVoice(emitter.channel);
+			numStolen++;
+			if (!emitter.looping) {
+				destroyEmitter(candidates[i].emitterId);
+			}
+		}
+	}
+
+	int nextChannel = 0;
+	for (size_t i = 0; i < numSelected; i++) {
+		int emitterId = candidates[i].emitterId;
+		if (emitters[emitterId].channel < 0) {
+			while (voices[nextChannel] >= 0) {
+				nextChannel++;
+			}
+			assignVoice(emitterId, nextChannel);
+		} else {
+			positionVoice(emitters[emitterId].channel);
+		}
+	}
+}
+
+void VoiceManager::free() {
+	Mix_HaltChannel(-1);
+	emitters.clear();
+	freeEmitters.clear();
+	voices.clear();
+	candidates.clear();
+}
+
+int VoiceManager::getNumVoices() {
+	return static_cast<int>(voices.size());
+}
+
+int VoiceManager::getNumPlaying() {
+	return static_cast<int>(std::count_if(voices.begin(), voices.end(), [](int emitterId) { return emitterId >= 0; }));
+}
+
+int VoiceManager::getNumCulled() {
+	return numCulled;
+}
+
+int VoiceManager::getNumStolen() {
+	return numStolen;
+}
+
+int VoiceManager::distanceSquared(const SoundEmitter& emitter) {
+	int dx = emitter.posX - listener.x;
+	int dy = emitter.posY - listener.y;
+	return dx * dx + dy * dy;
+}
+
+bool VoiceManager::isAudible(int distanceSquared) {
+	return distanceSquared < hearingDistance * hearingDistance;
+}
+
+bool VoiceManager::outranks(const Candidate& candidateA, const Candidate& candidateB) {
+	if (candidateA.priority != candidateB.priority) {
+		return candidateA.priority > candidateB.priority;
+	}
+	return candidateA.distanceSquared < candidateB.distanceSquared;
+}
+
+int VoiceManager::allocateEmitter() {
+	int emitterId;
+	if (!freeEmitters.empty()) {
+		emitterId = freeEmitters.back();
+		freeEmitters.pop_back();
+		emitters[emitterId] = SoundEmitter();
+	} else {
+		emitterId = static_cast<int>(emitters.size());
+		emitters.emplace_back();
+	}
+	emitters[emitterId].alive = true;
+	return emitterId;
+}
+
+int VoiceManager::findVoice(const Candidate& candidate) {
+	int victim = -1;
+	Candidate victimCandidate = candidate;
+	for (int channel = 0; channel < static_cast<int>(voices.size()); channel++) {
+		int emitterId = voices[channel];
+		if (emitterId < 0) {
+			return channel;
+		}
+		Candidate current{emitterId, emitters[emitterId].priority, distanceSquared(emitters[emitterId])};
+		if (outranks(victimCandidate, current)) {
+			victim = channel;
+			victimCandidate = current;
+		}
+	}
+	if (victim >= 0) {
+		int emitterId = voices[victim];
+		Mix_HaltChannel(victim);
+		releaseVoice(victim);
+		numStolen++;
+		if (!emitters[emitterId].looping) {
+			destroyEmitter(emitterId);
+		}
+	}
+	return victim;
+}
+
+bool VoiceManager::assignVoice(int emitterId, int channel) {
+	SoundEmitter& emitter = emitters[emitterId];
+	voices[channel] = emitterId;
+	emitter.channel = channel;
+	positionVoice(channel);
+	if (Mix_PlayChannel(channel, emitter.chunk, emitter.looping ? -1 : 0) < 0) {
+		printf("Unable to play sound on channel %d! Error: %s\n", channel, Mix_GetError());
+		releaseVoice(channel);
+		return false;
+	}
+	return true;
+}
+
+void VoiceManager::releaseVoice(int channel) {
+	int emitterId = voices[channel];
+	if (emitterId >= 0) {
+		emitters[emitterId].channel = -1;
+	}
+	voices[channel] = -1;
+}
+
+void VoiceManager::positionVoice(int channel) {
+	const SoundEmitter& emitter = emitters[voices[channel]];
+	int dx = emitter.posX - listener.x;
+	int dy = emitter.posY - listener.y;
+	double angle = atan2(static_cast<double>(dx), static_cast<double>(-dy)) * (180.0 / M_PI);
+	if (angle < 0) {
+		angle += 360;
+	}
+	int distance = static_cast<int>(sqrt(static_cast<double>(dx * dx + dy * dy)) * 255 / hearingDistance);
+	Mix_SetPosition(channel, static_cast<Sint16>(angle), static_cast<Uint8>(std::min(distance, 255)));
+}
@@ -0,0 +1,118 @@
+#include <core/WidgetManager.h>
+
+WidgetManager::WidgetManager() {
+	columns = 0;
+	rows = 0;
+	cellSize = DEFAULT_CELL_SIZE;
+	hovered = nullptr;
+}
+
+void WidgetManager::init(int width, int height, int cellSize) {
+	this->cellSize = SDL_max(cellSize, 1);
+	columns = SDL_max((width + this->cellSize - 1) / this->cellSize, 1);
+	rows = SDL_max((height + this->cellSize - 1) / this->cellSize, 1);
+	rebuild();
+}
+
+void WidgetManager::add(Button* button) {
+	widgets.push_back(button);
+	insert(static_cast<int>(widgets.size()) - 1);
+}
+
+void WidgetManager::rebuild() {
+	cells.assign(columns * rows, std::vector<int>());
+	for (int i = 0; i < static_cast<int>(widgets.size()); i++) {
+		insert(i);
+	}
+	hovered = nullptr;
+}
+
+void WidgetManager::clear() {
+	widgets.clear();
+	rebuild();
+}
+
+void WidgetManager::handleEvent(SDL_Event& event) {
+	int x, y;
+	if (event.type == SDL_MOUSEMOTION) {
+		x = event.motion.x;
+		y = event.motion.y;
+	} else if (event.type == SDL_MOUSEBUTTONDOWN || event.type == SDL_MOUSEBUTTONUP) {
+		x = event.button.x;
+		y = event.button.y;
+	} else {
+		return;
+	}
+	Button* hit = hitTest(x, y);
+	if (hovered && hovered != hit) {
+		hovered->setSprite(BUTTON_SPRITE_MOUSE_OUT);
+	}
+	hovered = hit;
+	if (!hit) {
+		return;
+	}
+	switch (event.type) {
+		case SDL_MOUSEMOTION: {
+			hit->setSprite(BUTTON_SPRITE_MOUSE_OVER_MOTION);
+			break;
+		}
+		case SDL_MOUSEBUTTONDOWN: {
+			hit->setSprite(BUTTON_SPRITE_MOUSE_DOWN);
+			break;
+		}
+		case SDL_MOUSEBUTTONUP: {
+			hit->setSprite(BUTTON_SPRITE_MOUSE_UP);
+			break;
+		}
+		default: {
+			break;
+		}
+	}
+}
+
+Button* WidgetManager::hitTest(int x, int y) {
+	int cell = getCell(x, y);
+	if (cell < 0) {
+		return nullptr;
+	}
+	const auto& candidates = cells[cell];
+	for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+		if (widgets[*it]->contains(x, y)) {
+			return widgets[*it];
+		}
+	}
+	return nullptr;
+}
+
+Button* WidgetManager::getHovered() {
+	return hovered;
+}
+
+int WidgetManager::getNumWidgets() {
+	return static_cast<int>(widgets.size());
+}
+
+void WidgetManager::insert(int index) {
+	if (cells.empty()) {
+		return;
+	}
+	SDL_Rect rect = widgets[index]->getRect();
+	int left = SDL_min(SDL_max(rect.x / cellSize, 0), columns - 1);
+	int top = SDL_min(SDL_max(rect.y / cellSize, 0), rows - 1);
+	int right = SDL_min(SDL_max((rect.x + rect.w) / cellSize, 0), columns - 1);
+	int bottom = SDL_min(SDL_max((rect.y + rect.h) / cellSize, 0), rows - 1);
+	for (int row = top; row <= bottom; row++) {
+		for (int column = left; column <= right; column++) {
+			cells[row * columns + column].push_back(index);
+		}
+	}
+}
+
+int WidgetManager::getCell(int x, int y) {
+	if (cells.empty()) {
+		return -1;
+	}
+	int column = SDL_min(SDL_max(x / cellSize, 0), columns - 1);
+	int row = SDL_min(SDL_max(y / cellSize, 0), rows - 1);
+	return row * columns + column;
+}
@@ -9,6 +9,7 @@ Window::Window() {
 	keyboardFocus = false;
 	fullScreen = false;
 	minimized = false;
+	dirty = true;
 }
 
 bool Window::init() {
@@ -27,18 +28,18 @@ SDL_Renderer* Window::createRenderer() {
 	return SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
 }
 
-void Window::handleEvent(SDL_Event& event, SDL_Renderer* renderer) {
+void Window::handleEvent(SDL_Event& event) {
 	if (event.type == SDL_WINDOWEVENT) {
 		bool updateTitle = false;
 		switch (event.window.event) {
 			case SDL_WINDOWEVENT_SIZE_CHANGED: {
 				width = event.window.data1;
 				height = event.window.data2;
-				SDL_RenderPresent(renderer);
+				dirty = true;
 				break;
 			}
 			case SDL_WINDOWEVENT_EXPOSED: {
-				SDL_RenderPresent(renderer);
+				dirty = true;
 				break;
 			}
 			case SDL_WINDOWEVENT_ENTER: {
@@ -67,10 +68,12 @@ void Window::handleEvent(SDL_Event& event, SDL_Renderer* renderer) {
 			}
 			case SDL_WINDOWEVENT_MAXIMIZED: {
 				minimized = false;
+				dirty = true;
 				break;
 			}
 			case SDL_WINDOWEVENT_RESTORED: {
 				minimized = false;
+				dirty = true;
 				break;
 			}
 			default: {
@@ -91,6 +94,7 @@ void Window::handleEvent(SDL_Event& event, SDL_Renderer* renderer) {
 			fullScreen = true;
 			minimized = false;
 		}
+		dirty = true;
 	}
 }
 
@@ -119,6 +123,26 @@ bool Window::isMinimized() {
 	return minimized;
 }
 
+void Window::invalidate() {
+	dirty = true;
+}
+
+bool Window::needsRedraw() {
+	return dirty && !minimized;
+}
+
+void Window::validate() {
+	dirty = false;
+}
+
+bool Window::waitForEvent(Uint32 timeout) {
+	// A pending redraw must not wait for the next event.
+	if (needsRedraw()) {
+		return SDL_PollEvent(nullptr) == 1;
+	}
+	return SDL_WaitEventTimeout(nullptr, timeout) == 1;
+}
+
 int WindowEx::numDisplays = 0;
 
 SDL_Rect* WindowEx::displayBounds = nullptr;
@@ -133,9 +157,11 @@ WindowEx::WindowEx() {
 	fullScreen = false;
 	minimized = false;
 	shown = false;
+	vsync = false;
+	dirty = true;
 }
 
-bool WindowEx::init() {
+bool WindowEx::init(bool vsync) {
 	window = SDL_CreateWindow("Window", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
 	if (!window) {
 		printf("Window could not be created! Error: %s\n", SDL_GetError());
@@ -144,12 +170,14 @@ bool WindowEx::init() {
 		keyboardFocus = true;
 		width = WINDOW_WIDTH;
 		height = WINDOW_HEIGHT;
-		renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+		renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | (vsync ? SDL_RENDERER_PRESENTVSYNC : 0));
 		if (!renderer) {
 			printf("Renderer could not be created! Error: %s\n", SDL_GetError());
 			SDL_DestroyWindow(window);
 			window = nullptr;
 		} else {
+			this->vsync = vsync;
+			dirty = true;
 			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
 			windowID = SDL_GetWindowID(window);
 			windowDisplayID = SDL_GetWindowDisplayIndex(window);
@@ -170,6 +198,7 @@ void WindowEx::handleEvent(SDL_Event& event) {
 			}
 			case SDL_WINDOWEVENT_SHOWN: {
 				shown = true;
+				dirty = true;
 				break;
 			}
 			case SDL_WINDOWEVENT_HIDDEN: {
@@ -179,11 +208,11 @@ void WindowEx::handleEvent(SDL_Event& event) {
 			case SDL_WINDOWEVENT_SIZE_CHANGED: {
 				width = event.window.data1;
 				height = event.window.data2;
-				SDL_RenderPresent(renderer);
+				dirty = true;
 				break;
 			}
 			case SDL_WINDOWEVENT_EXPOSED: {
-				SDL_RenderPresent(renderer);
+				dirty = true;
 				break;
 			}
 			case SDL_WINDOWEVENT_ENTER: {
@@ -212,10 +241,12 @@ void WindowEx::handleEvent(SDL_Event& event) {
 			}
 			case SDL_WINDOWEVENT_MAXIMIZED: {
 				minimized = false;
+				dirty = true;
 				break;
 			}
 			case SDL_WINDOWEVENT_RESTORED: {
 				minimized = false;
+				dirty = true;
 				break;
 			}
 			case SDL_WINDOWEVENT_CLOSE: {
@@ -291,6 +322,7 @@ void WindowEx::render() {
 		SDL_RenderClear(renderer);
 		// Render nothing
 		SDL_RenderPresent(renderer);
+		dirty = false;
 	}
 }
 
@@ -323,4 +355,32 @@ bool WindowEx::isMinimized() {
 
 bool WindowEx::isShown() {
 	return shown;
+}
+
+bool WindowEx::isVisible() {
+	return shown && !minimized;
+}
+
+bool WindowEx::hasVsync() {
+	return vsync;
+}
+
+void WindowEx::invalidate() {
+	dirty = true;
+}
+
+bool WindowEx::needsRedraw() {
+	return dirty && !minimized;
+}
+
+int WindowEx::getRefreshRate() {
+	SDL_DisplayMode mode;
+	if (SDL_GetCurrentDisplayMode(windowDisplayID, &mode) < 0 || mode.refresh_rate <= 0) {
+		return 60;
+	}
+	return mode.refresh_rate;
+}
+
+Uint32 WindowEx::getWindowID() {
+	return windowID;
 }
\ No newline at end of file
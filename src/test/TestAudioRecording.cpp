@@ -1,5 +1,7 @@
 #include <util/TestBase.h>
 #include <core/Texture.h>
+#include <core/AssetPack.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 #include <sstream>
 
@@ -7,7 +9,7 @@ struct TestAudioRecording : public BasicTestBaseWithTTFAndAudio {
 public:
 	bool loadMedia() override {
 		bool success = true;
-		font = TTF_OpenFont("font/prompt.ttf", 16);
+		font = TTF_OpenFontRW(AssetPack::openFile("font/prompt.ttf"), 1, 16);
 		if (!font) {
 			printf("Failed to load \"prompt\" font! Error: %s\n", TTF_GetError());
 			success = false;
@@ -40,6 +42,7 @@ public:
 		SDL_AudioDeviceID recordingDeviceId = 0;
 		SDL_AudioDeviceID playbackDeviceId = 0;
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
@@ -150,8 +153,8 @@ public:
 					}
 				}
 			}
-			SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
-			SDL_RenderClear(renderer);
+			TiledRenderer::setDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+			TiledRenderer::clear(renderer);
 			promptTexture.render(renderer, 0, 0);
 			if (recordingState == RecordingState::SELECTING_DEVICE) {
 				int heightOffset = promptTexture.getHeight() * 2;
@@ -160,7 +163,7 @@ public:
 					heightOffset += deviceTextures[i].getHeight() + 1;
 				}
 			}
-			SDL_RenderPresent(renderer);
+			TiledRenderer::present(renderer);
 		}
 	}
 
@@ -233,6 +236,9 @@ Uint32 TestAudioRecording::bufferByteMaxPosition = 0;
 
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	TestAudioRecording mainWindow;
 	mainWindow.test();
 	return 0;
@@ -1,4 +1,7 @@
 #include <util/TestBase.h>
+#include <core/AssetPack.h>
+#include <core/RenderLayer.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 #include <string>
 
@@ -20,6 +23,7 @@ public:
 		bool quit = false;
 		SDL_Event e;
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
@@ -40,7 +44,7 @@ public:
 
 	SDL_Texture* loadTexture(std::string path) {
 		SDL_Texture* newTexture = nullptr;
-		SDL_Surface* loadedSurface = IMG_Load(path.c_str());
+		SDL_Surface* loadedSurface = IMG_Load_RW(AssetPack::openFile(path), 1);
 		if (!loadedSurface) {
 			printf("Unable to load image %s! Error: %s\n", path.c_str(), IMG_GetError());
 		} else {
@@ -57,6 +61,10 @@ public:
 		return "Test Image Rendering";
 	}
 
+	bool supportsTiledRenderer() override {
+		return false;
+	}
+
 private:
 	SDL_Texture* texture = nullptr;
 };
@@ -70,38 +78,39 @@ struct TestBasicRendering : public BasicTestBase {
 		bool quit = false;
 		SDL_Event e;
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
 				}
 			}
 
-			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-			SDL_RenderClear(renderer);
+			TiledRenderer::setDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			TiledRenderer::clear(renderer);
 
 			SDL_Rect rect;
 			rect.x = WINDOW_WIDTH / 4;
 			rect.y = WINDOW_HEIGHT / 4;
 			rect.w = WINDOW_WIDTH / 2;
 			rect.h = WINDOW_HEIGHT / 2;
-			SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0xFF, 0xFF);
-			SDL_RenderFillRect(renderer, &rect);
+			TiledRenderer::setDrawColor(renderer, 0x00, 0x00, 0xFF, 0xFF);
+			TiledRenderer::fillRect(renderer, &rect);
 
 			SDL_Rect otherRect;
 			otherRect.x = WINDOW_WIDTH / 6;
 			otherRect.y = WINDOW_HEIGHT / 6;
 			otherRect.w = 2 * WINDOW_WIDTH / 3;
 			otherRect.h = 2 * WINDOW_HEIGHT / 3;
-			SDL_SetRenderDrawColor(renderer, 0xFF, 0x69, 0xB4, 0xFF);
-			SDL_RenderDrawRect(renderer, &otherRect);
+			TiledRenderer::setDrawColor(renderer, 0xFF, 0x69, 0xB4, 0xFF);
+			TiledRenderer::drawRect(renderer, &otherRect);
 
-			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-			SDL_RenderDrawLine(renderer, WINDOW_WIDTH / 3, WINDOW_HEIGHT / 2, 2 * WINDOW_WIDTH / 3, WINDOW_HEIGHT / 2);
+			TiledRenderer::setDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			TiledRenderer::drawLine(renderer, WINDOW_WIDTH / 3, WINDOW_HEIGHT / 2, 2 * WINDOW_WIDTH / 3, WINDOW_HEIGHT / 2);
 			for (int i = WINDOW_HEIGHT / 3; i <= 2 * WINDOW_HEIGHT / 3; i += WINDOW_HEIGHT / 120) {
-				SDL_RenderDrawPoint(renderer, WINDOW_WIDTH / 2, i);
+				TiledRenderer::drawPoint(renderer, WINDOW_WIDTH / 2, i);
 			}
 
-			SDL_RenderPresent(renderer);
+			TiledRenderer::present(renderer);
 		}
 	}
 
@@ -123,22 +132,7 @@ public:
 			printf("Failed to load texture image!\n");
 			success = false;
 		}
-		return success;
-	}
-
-	void run() override {
-		bool quit = false;
-		SDL_Event e;
-		while (!quit) {
-			while (SDL_PollEvent(&e) != 0) {
-				if (e.type == SDL_QUIT) {
-					quit = true;
-				}
-			}
-
-			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-			SDL_RenderClear(renderer);
-
+		viewports.init(renderer, WINDOW_WIDTH, WINDOW_HEIGHT, [this](SDL_Renderer* renderer) {
 			SDL_Rect topLeftViewPort;
 			topLeftViewPort.x = 0;
 			topLeftViewPort.y = 0;
@@ -162,12 +156,32 @@ public:
 			bottomViewPort.h = WINDOW_HEIGHT / 2;
 			SDL_RenderSetViewport(renderer, &bottomViewPort);
 			SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+		});
+		return success;
+	}
 
+	void run() override {
+		bool quit = false;
+		SDL_Event e;
+		while (!quit) {
+			InputRecorder::frame();
+			while (SDL_PollEvent(&e) != 0) {
+				if (e.type == SDL_QUIT) {
+					quit = true;
+				} else {
+					viewports.handleEvent(e);
+				}
+			}
+
+			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			SDL_RenderClear(renderer);
+			viewports.render();
 			SDL_RenderPresent(renderer);
 		}
 	}
 
 	void close() override {
+		viewports.free();
 		SDL_DestroyTexture(texture);
 		texture = nullptr;
 		BasicTestBase::close();
@@ -175,7 +189,7 @@ public:
 
 	SDL_Texture* loadTexture(std::string path) {
 		SDL_Texture* newTexture = nullptr;
-		SDL_Surface* loadedSurface = IMG_Load(path.c_str());
+		SDL_Surface* loadedSurface = IMG_Load_RW(AssetPack::openFile(path), 1);
 		if (!loadedSurface) {
 			printf("Unable to load image %s! Error: %s\n", path.c_str(), IMG_GetError());
 		} else {
@@ -192,14 +206,22 @@ public:
 		return "Test Viewport";
 	}
 
+	bool supportsTiledRenderer() override {
+		return false;
+	}
+
 private:
 	SDL_Texture* texture = nullptr;
+	RenderLayer viewports;
 };
 
 }
 
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	{
 		test_image_rendering::TestBasicRendering mainWindow;
 		mainWindow.test();
@@ -1,5 +1,6 @@
 #include <util/TestBase.h>
 #include <core/Texture.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 
 struct TestBasicRenderingEx : public BasicTestBase {
@@ -21,15 +22,16 @@ public:
 		bool quit = false;
 		SDL_Event e;
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
 				}
 			}
-			SDL_RenderClear(renderer);
+			TiledRenderer::clear(renderer);
 			backgroundTexture.render(renderer, 0, 0);
 			characterTexture.render(renderer, WINDOW_WIDTH / 2 + 40, WINDOW_HEIGHT / 2 + 40);
-			SDL_RenderPresent(renderer);
+			TiledRenderer::present(renderer);
 		}
 	}
 
@@ -50,6 +52,9 @@ private:
 
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	TestBasicRenderingEx mainWindow;
 	mainWindow.test();
 	return 0;
@@ -1,4 +1,7 @@
 #include <util/TestBase.h>
+#include <core/MappedBitmap.h>
+#include <core/SurfaceCompositor.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 #include <string>
 
@@ -24,7 +27,8 @@ public:
 				printf("Window could not be created! Error: %s\n", SDL_GetError());
 				success = false;
 			} else {
-				screenSurface = SDL_GetWindowSurface(window);
+				compositor.init(window);
+				screenSurface = compositor.getSurface();
 			}
 		}
 		return success;
@@ -32,27 +36,27 @@ public:
 
 	bool loadMedia() override {
 		bool success = true;
-		keyPressSurfaces[KEY_PRESS_SURFACE_DEFAULT] = loadSurface("image/default.bmp");
+		keyPressSurfaces[KEY_PRESS_SURFACE_DEFAULT] = loadSurface(KEY_PRESS_SURFACE_DEFAULT, "image/default.bmp");
 		if (!keyPressSurfaces[KEY_PRESS_SURFACE_DEFAULT]) {
 			printf("Failed to load default image!\n");
 			success = false;
 		}
-		keyPressSurfaces[KEY_PRESS_SURFACE_UP] = loadSurface("image/up.bmp");
+		keyPressSurfaces[KEY_PRESS_SURFACE_UP] = loadSurface(KEY_PRESS_SURFACE_UP, "image/up.bmp");
 		if (!keyPressSurfaces[KEY_PRESS_SURFACE_UP]) {
 			printf("Failed to load up image!\n");
 			success = false;
 		}
-		keyPressSurfaces[KEY_PRESS_SURFACE_DOWN] = loadSurface("image/down.bmp");
+		keyPressSurfaces[KEY_PRESS_SURFACE_DOWN] = loadSurface(KEY_PRESS_SURFACE_DOWN, "image/down.bmp");
 		if (!keyPressSurfaces[KEY_PRESS_SURFACE_DOWN]) {
 			printf("Failed to load up image!\n");
 			success = false;
 		}
-		keyPressSurfaces[KEY_PRESS_SURFACE_LEFT] = loadSurface("image/left.bmp");
+		keyPressSurfaces[KEY_PRESS_SURFACE_LEFT] = loadSurface(KEY_PRESS_SURFACE_LEFT, "image/left.bmp");
 		if (!keyPressSurfaces[KEY_PRESS_SURFACE_LEFT]) {
 			printf("Failed to load left image!\n");
 			success = false;
 		}
-		keyPressSurfaces[KEY_PRESS_SURFACE_RIGHT] = loadSurface("image/right.bmp");
+		keyPressSurfaces[KEY_PRESS_SURFACE_RIGHT] = loadSurface(KEY_PRESS_SURFACE_RIGHT, "image/right.bmp");
 		if (!keyPressSurfaces[KEY_PRESS_SURFACE_RIGHT]) {
 			printf("Failed to load right image!\n");
 			success = false;
@@ -65,7 +69,9 @@ public:
 		currentSurface = keyPressSurfaces[KEY_PRESS_SURFACE_DEFAULT];
 		SDL_Event e;
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
+				compositor.handleEvent(e);
 				if (e.type == SDL_QUIT) {
 					quit = true;
 				} else if (e.type == SDL_KEYDOWN) {
@@ -98,14 +104,15 @@ public:
 			stretchRect.y = WINDOW_HEIGHT >> 2;
 			stretchRect.w = WINDOW_WIDTH >> 1;
 			stretchRect.h = WINDOW_HEIGHT >> 1;
-			SDL_BlitScaled(currentSurface, nullptr, screenSurface, &stretchRect);
-			SDL_UpdateWindowSurface(window);
+			compositor.blitScaled(currentSurface, nullptr, &stretchRect);
+			compositor.present();
 		}
 	}
 
 	void close() override {
+		compositor.printStatistics();
 		for (int i = 0; i < KEY_PRESS_SURFACE_TOTAL; i++) {
-			SDL_FreeSurface(keyPressSurfaces[i]);
+			keyPressBitmaps[i].free();
 			keyPressSurfaces[i] = nullptr;
 		}
 		SDL_DestroyWindow(window);
@@ -114,19 +121,13 @@ public:
 		SDL_Quit();
 	}
 
-	SDL_Surface* loadSurface(std::string path) {
-		SDL_Surface* optimizedSurface = nullptr;
-		SDL_Surface* loadedSurface = SDL_LoadBMP(path.c_str());
-		if (!loadedSurface) {
+	SDL_Surface* loadSurface(KeyPressSurfaces index, std::string path) {
+		MappedBitmap& bitmap = keyPressBitmaps[index];
+		if (!bitmap.load(path, screenSurface->format)) {
 			printf("Unable to load image %s! Error: %s\n", path.c_str(), SDL_GetError());
-		} else {
-			optimizedSurface = SDL_ConvertSurface(loadedSurface, screenSurface->format, 0);
-			if (!optimizedSurface) {
-				printf("Unable to optimize image %s! Error: %s\n", path.c_str(), SDL_GetError());
-			}
-			SDL_FreeSurface(loadedSurface);
+			return nullptr;
 		}
-		return optimizedSurface;
+		return bitmap.getSurface();
 	}
 
 	std::string name() override {
@@ -134,13 +135,18 @@ public:
 	}
 
 private:
+	SurfaceCompositor compositor;
 	SDL_Surface* screenSurface = nullptr;
+	MappedBitmap keyPressBitmaps[KEY_PRESS_SURFACE_TOTAL];
 	SDL_Surface* keyPressSurfaces[KEY_PRESS_SURFACE_TOTAL];
 	SDL_Surface* currentSurface = nullptr;
 };
 
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	TestBasicSDL2 mainWindow;
 	mainWindow.test();
 	return 0;
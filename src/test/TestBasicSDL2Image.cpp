@@ -1,4 +1,7 @@
 #include <util/TestBase.h>
+#include <core/AssetPack.h>
+#include <core/SurfaceCompositor.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 #include <string>
 
@@ -20,7 +23,8 @@ public:
 					printf("SDL2_image could not initialize! Error: %s\n", IMG_GetError());
 					success = false;
 				} else {
-					screenSurface = SDL_GetWindowSurface(window);
+					compositor.init(window);
+					screenSurface = compositor.getSurface();
 				}
 			}
 		}
@@ -41,17 +45,20 @@ public:
 		bool quit = false;
 		SDL_Event e;
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
+				compositor.handleEvent(e);
 				if (e.type == SDL_QUIT) {
 					quit = true;
 				}
 			}
-			SDL_BlitSurface(pngSurface, nullptr, screenSurface, nullptr);
-			SDL_UpdateWindowSurface(window);
+			compositor.blit(pngSurface, nullptr, nullptr);
+			compositor.present();
 		}
 	}
 
 	void close() override {
+		compositor.printStatistics();
 		SDL_FreeSurface(pngSurface);
 		pngSurface = nullptr;
 		SDL_DestroyWindow(window);
@@ -63,7 +70,7 @@ public:
 
 	SDL_Surface* loadSurface(std::string path) {
 		SDL_Surface* optimizedSurface = nullptr;
-		SDL_Surface* loadedSurface = IMG_Load(path.c_str());
+		SDL_Surface* loadedSurface = IMG_Load_RW(AssetPack::openFile(path), 1);
 		if (!loadedSurface) {
 			printf("Unable to load image %s! Error: %s\n", path.c_str(), IMG_GetError());
 		} else {
@@ -81,12 +88,16 @@ public:
 	}
 
 private:
+	SurfaceCompositor compositor;
 	SDL_Surface* screenSurface = nullptr;
 	SDL_Surface* pngSurface = nullptr;
 };
 
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	TestBasicSDL2Image mainWindow;
 	mainWindow.test();
 	return 0;
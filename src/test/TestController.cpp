@@ -1,5 +1,6 @@
 #include <util/TestBase.h>
 #include <core/Texture.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 
 const int JOYSTICK_DEAD_ZONE = 8000;
@@ -28,6 +29,7 @@ public:
 		SDL_Event e;
 		int xDir = 0, yDir = 0;
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
@@ -57,8 +59,8 @@ public:
 					}
 				}
 			}
-			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-			SDL_RenderClear(renderer);
+			TiledRenderer::setDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			TiledRenderer::clear(renderer);
 			double joystickAngle = atan2(static_cast<double>(yDir), static_cast<double>(yDir)) * (180.0 / M_PI);
 			if (xDir == 0 && yDir == 0) {
 				joystickAngle = 0;
@@ -66,7 +68,7 @@ public:
 			backgroundTexture.render(renderer, 0, 0);
 			sunTexture.render(renderer, WINDOW_WIDTH - 100, 10, nullptr, joystickAngle);
 			characterTexture.render(renderer, WINDOW_WIDTH / 2 + 40, WINDOW_HEIGHT / 2 + 40);
-			SDL_RenderPresent(renderer);
+			TiledRenderer::present(renderer);
 		}
 	}
 
@@ -89,6 +91,9 @@ private:
 
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	TestController mainWindow;
 	mainWindow.test();
 	return 0;
@@ -1,12 +1,18 @@
 #include <util/TestBase.h>
 #include <core/Texture.h>
+#include <core/RetainedUI.h>
+#include <core/RecordStore.h>
+#include <core/AsyncSaver.h>
+#include <core/AssetPack.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
+#include <vector>
 
 struct TestFile : public BasicTestBaseWithTTF {
 public:
 	bool loadMedia() override {
 		bool success = true;
-		font = TTF_OpenFont("font/prompt.ttf", 16);
+		font = TTF_OpenFontRW(AssetPack::openFile("font/prompt.ttf"), 1, 16);
 		if (!font) {
 			printf("Failed to load \"prompt\" font! Error: %s\n", TTF_GetError());
 			success = false;
@@ -16,12 +22,18 @@ public:
 				printf("Failed to render prompt text texture!\n");
 				success = false;
 			}
+			ui.init(renderer, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_Color{0x00, 0x00, 0x00, 0xFF});
+			ui.addWidget(SDL_Rect{0, 0, promptTextTexture.getWidth(), promptTextTexture.getHeight()}, [this](SDL_Renderer* renderer, int, int) {
+				promptTextTexture.render(renderer, 0, 0);
+			});
+			for (int i = 0; i < NUM_VISIBLE_ELEMENTS; i++) {
+				dataWidgets[i] = ui.addWidget(SDL_Rect{170 + 35 * i, 0, 0, 0}, [this, i](SDL_Renderer* renderer, int, int) {
+					dataTextures[i].render(renderer, 0, 0);
+				});
+			}
 			success = loadDataFromFile(FILE_PATH);
-			for (int i = 0; i < NUM_ELEMENTS; i++) {
-				if (!dataTextures[i].loadFromRenderedText(renderer, font, std::to_string(data[i]), textColor)) {
-					printf("Failed to render data text texture!\n");
-					success = false;
-				}
+			if (success) {
+				scrollTo(0);
 			}
 		}
 		return success;
@@ -29,70 +41,79 @@ public:
 
 	bool loadDataFromFile(std::string path) {
 		bool success = true;
-		SDL_RWops* file = SDL_RWFromFile(path.c_str(), "r+b");
-		if (!file) {
-			printf("Warning: Unable to open file \"%s\"! Error: %s\n", SDL_GetError(), path.c_str());
-			file = SDL_RWFromFile(path.c_str(), "w+b");
-			if (!file) {
-				printf("Unable to create file \"%s\"! Error: %s\n", SDL_GetError(), path.c_str());
-				success = false;
-			} else {
-				printf("New file \"%s\" created!", path.c_str());
-				for (int i = 0; i < NUM_ELEMENTS; i++) {
-					data[i] = 0;
-					SDL_RWwrite(file, &data[i], sizeof(Sint16), 1);
-				}
-				SDL_RWclose(file);
-			}
+		if (!data.open(path)) {
+			printf("Unable to map file \"%s\"! Error: %s\n", path.c_str(), SDL_GetError());
+			success = false;
+		} else if (!restoreFromSnapshot(path) || (data.getCount() < NUM_ELEMENTS && !data.resize(NUM_ELEMENTS))) {
+			printf("Unable to resize file \"%s\"! Error: %s\n", path.c_str(), SDL_GetError());
+			success = false;
 		} else {
-			printf("Reading file \"%s\"!", path.c_str());
-			for (int i = 0; i < NUM_ELEMENTS; i++) {
-				SDL_RWread(file, &data[i], sizeof(Sint16), 1);
+			printf("Mapped file \"%s\" with %lld elements!\n", path.c_str(), static_cast<long long>(data.getCount()));
+			if (!saver.init()) {
+				printf("Warning: Unable to start background saving!\n");
 			}
-			SDL_RWclose(file);
 		}
 		return success;
 	}
 
+	bool restoreFromSnapshot(std::string path) {
+		// The mapping is written back even if the test crashes, so data.bin is
+		// never older than the snapshot. The snapshot only fills in records that
+		// data.bin has lost, e.g. after it was deleted or truncated.
+		std::vector<Uint8> payload;
+		if (!AsyncSaver::load(SAVE_PATH, SAVE_VERSION, payload)) {
+			return true;
+		}
+		Sint64 first = data.getCount();
+		Sint64 count = static_cast<Sint64>(payload.size() / sizeof(Sint16));
+		if (count <= first) {
+			return true;
+		}
+		if (!data.resize(count)) {
+			return false;
+		}
+		printf("Restoring %lld elements of file \"%s\" from \"%s\"!\n", static_cast<long long>(count - first), path.c_str(), SAVE_PATH.c_str());
+		SDL_memcpy(data.getData() + first, payload.data() + first * sizeof(Sint16), static_cast<size_t>(count - first) * sizeof(Sint16));
+		return true;
+	}
+
 	void run() override {
 		bool quit = false;
 		SDL_Event e;
-		SDL_Color normalColor{0xFF, 0xFF, 0xFF};
-		SDL_Color highlightColor{0x00, 0x00, 0xFF};
-		int currentId = 0;
 		while (!quit) {
-			bool renderText = false;
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
+				ui.handleEvent(e);
 				if (e.type == SDL_QUIT) {
 					quit = true;
 				} else if (e.type == SDL_KEYDOWN) {
 					switch (e.key.keysym.sym) {
 						case SDLK_UP: {
 							data[currentId]++;
-							dataTextures[currentId].loadFromRenderedText(renderer, font, std::to_string(data[currentId]), highlightColor);
+							renderDataTexture(currentId);
+							dirty = true;
 							break;
 						}
 						case SDLK_DOWN: {
 							data[currentId]--;
-							dataTextures[currentId].loadFromRenderedText(renderer, font, std::to_string(data[currentId]), highlightColor);
+							renderDataTexture(currentId);
+							dirty = true;
 							break;
 						}
 						case SDLK_LEFT: {
-							dataTextures[currentId].loadFromRenderedText(renderer, font, std::to_string(data[currentId]), normalColor);
-							currentId--;
-							if (currentId < 0) {
-								currentId = NUM_ELEMENTS - 1;
-							}
-							dataTextures[currentId].loadFromRenderedText(renderer, font, std::to_string(data[currentId]), highlightColor);
+							select(currentId - 1);
 							break;
 						}
 						case SDLK_RIGHT: {
-							dataTextures[currentId].loadFromRenderedText(renderer, font, std::to_string(data[currentId]), normalColor);
-							currentId++;
-							if (currentId >= NUM_ELEMENTS) {
-								currentId = 0;
-							}
-							dataTextures[currentId].loadFromRenderedText(renderer, font, std::to_string(data[currentId]), highlightColor);
+							select(currentId + 1);
+							break;
+						}
+						case SDLK_PAGEUP: {
+							select(currentId - NUM_VISIBLE_ELEMENTS);
+							break;
+						}
+						case SDLK_PAGEDOWN: {
+							select(currentId + NUM_VISIBLE_ELEMENTS);
 							break;
 						}
 						default: {
@@ -101,29 +122,72 @@ public:
 					}
 				}
 			}
-			SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
-			SDL_RenderClear(renderer);
-			promptTextTexture.render(renderer, 0, 0);
-			for (int i = 0; i < NUM_ELEMENTS; i++) {
-				dataTextures[i].render(renderer, 170 + 35 * i, 0);
+			if (dirty && SDL_GetTicks() - lastSaveTicks >= AUTOSAVE_TICKS) {
+				saveData();
 			}
+			ui.update();
+			ui.render();
 			SDL_RenderPresent(renderer);
 		}
 		SDL_StopTextInput();
 	}
 
-	void close() override {
-		SDL_RWops* file = SDL_RWFromFile(FILE_PATH.c_str(), "r+b");
-		if (!file) {
-			printf("Unable to save file \"%s\"! Error: %s\n", SDL_GetError(), FILE_PATH.c_str());
+	void saveData() {
+		saver.save(SAVE_PATH, SAVE_VERSION, data.getData(), data.getCount() * sizeof(Sint16));
+		lastSaveTicks = SDL_GetTicks();
+		dirty = false;
+	}
+
+	void select(Sint64 id) {
+		Sint64 numElements = data.getCount();
+		id %= numElements;
+		if (id < 0) {
+			id += numElements;
+		}
+		Sint64 previousId = currentId;
+		currentId = id;
+		if (currentId < firstVisibleId || currentId >= firstVisibleId + NUM_VISIBLE_ELEMENTS) {
+			scrollTo(currentId - currentId % NUM_VISIBLE_ELEMENTS);
 		} else {
-			printf("Saving file \"%s\"!", FILE_PATH.c_str());
-			for (int i = 0; i < NUM_ELEMENTS; i++) {
-				SDL_RWwrite(file, &data[i], sizeof(Sint16), 1);
+			renderDataTexture(previousId);
+			renderDataTexture(currentId);
+		}
+	}
+
+	void scrollTo(Sint64 id) {
+		firstVisibleId = id;
+		for (int i = 0; i < NUM_VISIBLE_ELEMENTS; i++) {
+			if (firstVisibleId + i < data.getCount()) {
+				renderDataTexture(firstVisibleId + i);
+			} else {
+				dataTextures[i].free();
+				ui.setWidgetVisible(dataWidgets[i], false);
+			}
+		}
+	}
+
+	void renderDataTexture(Sint64 id) {
+		SDL_Color normalColor{0xFF, 0xFF, 0xFF};
+		SDL_Color highlightColor{0x00, 0x00, 0xFF};
+		if (id >= firstVisibleId && id < firstVisibleId + NUM_VISIBLE_ELEMENTS) {
+			int slot = static_cast<int>(id - firstVisibleId);
+			if (!dataTextures[slot].loadFromRenderedText(renderer, font, std::to_string(data[id]), id == currentId ? highlightColor : normalColor)) {
+				printf("Failed to render data text texture!\n");
 			}
-			SDL_RWclose(file);
+			ui.setWidgetRect(dataWidgets[slot], SDL_Rect{170 + 35 * slot, 0, dataTextures[slot].getWidth(), dataTextures[slot].getHeight()});
+			ui.setWidgetVisible(dataWidgets[slot], true);
+		}
+	}
+
+	void close() override {
+		if (dirty) {
+			printf("Saving file \"%s\"!\n", SAVE_PATH.c_str());
+			saveData();
 		}
-		for (int i = 0; i < NUM_ELEMENTS; i++) {
+		saver.free();
+		data.close();
+		ui.free();
+		for (int i = 0; i < NUM_VISIBLE_ELEMENTS; i++) {
 			dataTextures[i].free();
 		}
 		promptTextTexture.free();
@@ -136,17 +200,35 @@ public:
 		return "Test File";
 	}
 
+	bool supportsTiledRenderer() override {
+		return false;
+	}
+
 private:
 	static constexpr int NUM_ELEMENTS = 12;
+	static constexpr int NUM_VISIBLE_ELEMENTS = (WINDOW_WIDTH - 170) / 35;
+	static constexpr Uint32 SAVE_VERSION = 1;
+	static constexpr Uint32 AUTOSAVE_TICKS = 1000;
 	const std::string FILE_PATH = "data.bin";
+	const std::string SAVE_PATH = "data.sav";
 	TTF_Font* font = nullptr;
 	Texture promptTextTexture;
-	Sint16 data[NUM_ELEMENTS] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
-	Texture dataTextures[NUM_ELEMENTS];
+	RecordStore<Sint16> data;
+	Sint64 currentId = 0;
+	Sint64 firstVisibleId = 0;
+	AsyncSaver saver;
+	bool dirty = false;
+	Uint32 lastSaveTicks = 0;
+	Texture dataTextures[NUM_VISIBLE_ELEMENTS];
+	RetainedUI ui;
+	int dataWidgets[NUM_VISIBLE_ELEMENTS];
 };
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	TestFile mainWindow;
 	mainWindow.test();
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,164 @@
+#include <util/HeadlessAudio.h>
+#include <core/AssetPack.h>
+#include <SDL_mixer.h>
+#include <stdio.h>
+#include <math.h>
+#include <atomic>
+
+const int AUDIO_FREQUENCY = 44100;
+const int AUDIO_CHANNELS = 2;
+const int AUDIO_SAMPLES = 2048;
+const Uint32 BENCHMARK_TICKS = 3000;
+
+void printThroughput(const char* name, Uint64 samples, Uint64 elapsedCounter) {
+	double seconds = static_cast<double>(elapsedCounter) / SDL_GetPerformanceFrequency();
+	double samplesPerSecond = samples / seconds;
+	printf("%s: %llu samples in %.2f s, %.0f samples/s (%.1fx real time)\n", name, static_cast<unsigned long long>(samples), seconds, samplesPerSecond, samplesPerSecond / (AUDIO_FREQUENCY * AUDIO_CHANNELS));
+}
+
+struct TestCallbackThroughput {
+public:
+	bool init() {
+		bool success = true;
+		HeadlessAudio::enable("callback.raw", false);
+		if (SDL_Init(SDL_INIT_AUDIO) < 0) {
+			printf("SDL could not initialize! Error: %s\n", SDL_GetError());
+			success = false;
+		} else {
+			SDL_AudioSpec desiredSpec;
+			SDL_zero(desiredSpec);
+			desiredSpec.freq = AUDIO_FREQUENCY;
+			desiredSpec.format = AUDIO_S16SYS;
+			desiredSpec.channels = AUDIO_CHANNELS;
+			desiredSpec.samples = AUDIO_SAMPLES;
+			desiredSpec.callback = audioCallback;
+			desiredSpec.userdata = this;
+			deviceId = SDL_OpenAudioDevice(nullptr, SDL_FALSE, &desiredSpec, &obtainedSpec, 0);
+			if (deviceId == 0) {
+				printf("Failed to open audio device! Error: %s\n", SDL_GetError());
+				success = false;
+			}
+		}
+		return success;
+	}
+
+	bool loadMedia() {
+		bool success = true;
+		return success;
+	}
+
+	void run() {
+		Uint64 startCounter = SDL_GetPerformanceCounter();
+		SDL_PauseAudioDevice(deviceId, SDL_FALSE);
+		SDL_Delay(BENCHMARK_TICKS);
+		SDL_PauseAudioDevice(deviceId, SDL_TRUE);
+		printThroughput("Callback", samples, SDL_GetPerformanceCounter() - startCounter);
+	}
+
+	void close() {
+		SDL_CloseAudioDevice(deviceId);
+		deviceId = 0;
+		SDL_Quit();
+	}
+
+	static void audioCallback(void* userdata, Uint8* stream, int len) {
+		auto test = static_cast<TestCallbackThroughput*>(userdata);
+		Sint16* buffer = reinterpret_cast<Sint16*>(stream);
+		int numSamples = len / sizeof(Sint16);
+		for (int i = 0; i < numSamples; i += AUDIO_CHANNELS) {
+			Sint16 value = static_cast<Sint16>(8000 * sin(test->phase));
+			for (int j = 0; j < AUDIO_CHANNELS; j++) {
+				buffer[i + j] = value;
+			}
+			test->phase += 2 * M_PI * 440 / AUDIO_FREQUENCY;
+		}
+		test->samples += numSamples;
+	}
+
+private:
+	SDL_AudioDeviceID deviceId = 0;
+	SDL_AudioSpec obtainedSpec;
+	double phase = 0;
+	std::atomic<Uint64> samples{0};
+};
+
+struct TestMixerThroughput {
+public:
+	bool init() {
+		bool success = true;
+		HeadlessAudio::enable("mixer.raw", false);
+		if (SDL_Init(SDL_INIT_AUDIO) < 0) {
+			printf("SDL could not initialize! Error: %s\n", SDL_GetError());
+			success = false;
+		} else {
+			if (Mix_OpenAudio(AUDIO_FREQUENCY, MIX_DEFAULT_FORMAT, AUDIO_CHANNELS, AUDIO_SAMPLES) < 0) {
+				printf("SDL_mixer could not initialize! Error: %s\n", Mix_GetError());
+				success = false;
+			} else {
+				Mix_AllocateChannels(NUM_VOICES);
+			}
+		}
+		return success;
+	}
+
+	bool loadMedia() {
+		bool success = true;
+		soundEffect = Mix_LoadWAV_RW(AssetPack::openFile("sound/kitty.wav"), 1);
+		if (!soundEffect) {
+			printf("Failed to load \"kitty\" sound effect! Error: %s\n", Mix_GetError());
+			success = false;
+		}
+		return success;
+	}
+
+	void run() {
+		Mix_SetPostMix(postMixCallback, this);
+		Uint64 startCounter = SDL_GetPerformanceCounter();
+		for (int i = 0; i < NUM_VOICES; i++) {
+			Mix_PlayChannel(i, soundEffect, -1);
+		}
+		SDL_Delay(BENCHMARK_TICKS);
+		Mix_HaltChannel(-1);
+		Mix_SetPostMix(nullptr, nullptr);
+		printThroughput("Mixer", samples, SDL_GetPerformanceCounter() - startCounter);
+	}
+
+	void close() {
+		Mix_FreeChunk(soundEffect);
+		soundEffect = nullptr;
+		Mix_CloseAudio();
+		SDL_Quit();
+	}
+
+	static void postMixCallback(void* userdata, Uint8*, int len) {
+		auto test = static_cast<TestMixerThroughput*>(userdata);
+		test->samples += len / sizeof(Sint16);
+	}
+
+private:
+	static constexpr int NUM_VOICES = 32;
+	Mix_Chunk* soundEffect = nullptr;
+	std::atomic<Uint64> samples{0};
+};
+
+#define TEST(name) \
+{ \
+	name mainWindow; \
+	if (!mainWindow.init()) { \
+		printf("Failed to initialize!\n"); \
+	} \
+	else { \
+		if (!mainWindow.loadMedia()) { \
+			printf("Failed to load media!\n"); \
+		} else { \
+			mainWindow.run(); \
+		} \
+	} \
+	mainWindow.close(); \
+}
+
+int main(int, char**) {
+	TEST(TestCallbackThroughput)
+	TEST(TestMixerThroughput)
+	return 0;
+}
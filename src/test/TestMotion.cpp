@@ -1,107 +1,16 @@
 #include <util/TestBase.h>
 #include <core/Texture.h>
+#include <core/Scene.h>
+#include <core/EntityStore.h>
+#include <core/TripleBuffer.h>
+#include <core/RenderQueue.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 #include <vector>
 #include <math.h>
 
 namespace collision_detection {
 
-struct Dot {
-public:
-	static constexpr int DOT_WIDTH = 20;
-	static constexpr int DOT_HEIGHT = 20;
-	static constexpr int DOT_VEL = 10;
-
-	Dot() {
-		posX = 0;
-		posY = 0;
-		velX = 0;
-		velY = 0;
-		collider.w = DOT_HEIGHT;
-		collider.h = DOT_WIDTH;
-	}
-
-	void handleEvent(SDL_Event& e) {
-		if (e.type == SDL_KEYDOWN && e.key.repeat == 0) {
-			switch (e.key.keysym.sym) {
-				case SDLK_UP: {
-					velY -= DOT_VEL; break;
-				}
-				case SDLK_DOWN: {
-					velY += DOT_VEL; break;
-				}
-				case SDLK_LEFT: {
-					velX -= DOT_VEL; break;
-				}
-				case SDLK_RIGHT: {
-					velX += DOT_VEL; break;
-				}
-				default: {
-					break;
-				}
-			}
-		} else if (e.type == SDL_KEYUP && e.key.repeat == 0) {
-			switch (e.key.keysym.sym) {
-				case SDLK_UP: {
-					velY += DOT_VEL; break;
-				}
-				case SDLK_DOWN: {
-					velY -= DOT_VEL; break;
-				}
-				case SDLK_LEFT: {
-					velX += DOT_VEL; break;
-				}
-				case SDLK_RIGHT: {
-					velX -= DOT_VEL; break;
-				}
-				default: {
-					break;
-				}
-			}
-		}
-	}
-
-	void move(SDL_Rect& wall) {
-		posX += velX;
-		collider.x = posX;
-		if (posX < 0 || (posX + DOT_WIDTH > WINDOW_WIDTH) || checkCollision(wall, collider)) {
-			posX -= velX;
-			collider.x = posX;
-		}
-		posY += velY;
-		collider.y = posY;
-		if (posY < 0 || (posY + DOT_HEIGHT > WINDOW_HEIGHT) || checkCollision(wall, collider)) {
-			posY -= velY;
-			collider.y = posY;
-		}
-	}
-
-	bool checkCollision(SDL_Rect& recA, SDL_Rect& recB) {
-		if (recA.x + recA.w <= recB.x) {
-			return false;
-		}
-		if (recA.x >= recB.x + recB.w) {
-			return false;
-		}
-		if (recA.y + recA.h <= recB.y) {
-			return false;
-		}
-		if (recA.y >= recB.y + recB.h) {
-			return false;
-		}
-		return true;
-	}
-
-	void render(SDL_Renderer* renderer, Texture* dotTexture) {
-		dotTexture->render(renderer, posX, posY);
-	}
-
-private:
-	int posX, posY;
-	int velX, velY;
-	SDL_Rect collider;
-};
-
 struct TestMotion : public BasicTestBase {
 public:
 	bool loadMedia() override {
@@ -116,27 +25,32 @@ public:
 	void run() override {
 		bool quit = false;
 		SDL_Event e;
-		Dot dot;
+		SDL_Rect screen{0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
 		SDL_Rect wall;
 		wall.x = 300;
 		wall.y = 40;
 		wall.w = 40;
 		wall.h = 400;
+		EntityStore store;
+		store.setBounds(screen);
+		store.setColliders({wall});
+		Entity dot = store.create(0, 0, DOT_WIDTH, DOT_HEIGHT, &dotTexture);
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
 				} else {
-					dot.handleEvent(e);
+					store.handleEvent(dot, e, DOT_VEL);
 				}
 			}
-			dot.move(wall);
-			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-			SDL_RenderClear(renderer);
-			SDL_SetRenderDrawColor(renderer, 0xC0, 0x00, 0x00, 0xFF);
-			SDL_RenderDrawRect(renderer, &wall);
-			dot.render(renderer, &dotTexture);
-			SDL_RenderPresent(renderer);
+			store.move();
+			TiledRenderer::setDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			TiledRenderer::clear(renderer);
+			TiledRenderer::setDrawColor(renderer, 0xC0, 0x00, 0x00, 0xFF);
+			TiledRenderer::drawRect(renderer, &wall);
+			store.render(renderer, screen);
+			TiledRenderer::present(renderer);
 		}
 	}
 
@@ -150,6 +64,10 @@ public:
 	}
 
 private:
+	static constexpr int DOT_WIDTH = 20;
+	static constexpr int DOT_HEIGHT = 20;
+	static constexpr int DOT_VEL = 10;
+
 	Texture dotTexture;
 };
 
@@ -195,43 +113,7 @@ public:
 	}
 
 	void handleEvent(SDL_Event& e) {
-		if (e.type == SDL_KEYDOWN && e.key.repeat == 0) {
-			switch (e.key.keysym.sym) {
-				case SDLK_UP: {
-					velY -= DOT_VEL; break;
-				}
-				case SDLK_DOWN: {
-					velY += DOT_VEL; break;
-				}
-				case SDLK_LEFT: {
-					velX -= DOT_VEL; break;
-				}
-				case SDLK_RIGHT: {
-					velX += DOT_VEL; break;
-				}
-				default: {
-					break;
-				}
-			}
-		} else if (e.type == SDL_KEYUP && e.key.repeat == 0) {
-			switch (e.key.keysym.sym) {
-				case SDLK_UP: {
-					velY += DOT_VEL; break;
-				}
-				case SDLK_DOWN: {
-					velY -= DOT_VEL; break;
-				}
-				case SDLK_LEFT: {
-					velX += DOT_VEL; break;
-				}
-				case SDLK_RIGHT: {
-					velX -= DOT_VEL; break;
-				}
-				default: {
-					break;
-				}
-			}
-		}
+		EntityStore::handleArrowKeys(e, DOT_VEL, velX, velY);
 	}
 
 	void move(std::vector<SDL_Rect>& otherColliders) {
@@ -308,6 +190,7 @@ public:
 		Dot greenDot{0, 0};
 		Dot redDot{WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2};
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
@@ -316,11 +199,11 @@ public:
 				}
 			}
 			greenDot.move(redDot.getColliders());
-			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-			SDL_RenderClear(renderer);
+			TiledRenderer::setDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			TiledRenderer::clear(renderer);
 			greenDot.render(renderer, &greenDotTexture);
 			redDot.render(renderer, &redDotTexture);
-			SDL_RenderPresent(renderer);
+			TiledRenderer::present(renderer);
 		}
 	}
 
@@ -365,43 +248,7 @@ public:
 	}
 
 	void handleEvent(SDL_Event& e) {
-		if (e.type == SDL_KEYDOWN && e.key.repeat == 0) {
-			switch (e.key.keysym.sym) {
-				case SDLK_UP: {
-					velY -= DOT_VEL; break;
-				}
-				case SDLK_DOWN: {
-					velY += DOT_VEL; break;
-				}
-				case SDLK_LEFT: {
-					velX -= DOT_VEL; break;
-				}
-				case SDLK_RIGHT: {
-					velX += DOT_VEL; break;
-				}
-				default: {
-					break;
-				}
-			}
-		} else if (e.type == SDL_KEYUP && e.key.repeat == 0) {
-			switch (e.key.keysym.sym) {
-				case SDLK_UP: {
-					velY += DOT_VEL; break;
-				}
-				case SDLK_DOWN: {
-					velY -= DOT_VEL; break;
-				}
-				case SDLK_LEFT: {
-					velX += DOT_VEL; break;
-				}
-				case SDLK_RIGHT: {
-					velX -= DOT_VEL; break;
-				}
-				default: {
-					break;
-				}
-			}
-		}
+		EntityStore::handleArrowKeys(e, DOT_VEL, velX, velY);
 	}
 
 	void move(std::vector<SDL_Rect>& squares, Circle& circle) {
@@ -477,14 +324,18 @@ private:
 struct TestMotion : public BasicTestBase {
 public:
 	bool loadMedia() override {
-		bool success = true;
-		if (!greenDotTexture.loadFromFile(renderer, "image/green_dot.png")) {
-			printf("Failed to load \"green_dot\" texture image!\n");
-			success = false;
+		if (!scene.open("scene/circular_motion.scene")) {
+			printf("Failed to load \"circular_motion\" scene! Error: %s\n", SDL_GetError());
+			return false;
 		}
-		if (!redDotTexture.loadFromFile(renderer, "image/red_dot.png")) {
-			printf("Failed to load \"red_dot\" texture image!\n");
-			success = false;
+		bool success = true;
+		textures = std::vector<Texture>(scene.getNumTextures());
+		for (Uint32 i = 0; i < scene.getNumTextures(); i++) {
+			const char* path = scene.getString(scene.getTexture(i)->pathOffset);
+			if (!textures[i].loadFromFile(renderer, path)) {
+				printf("Failed to load \"%s\" texture image!\n", path);
+				success = false;
+			}
 		}
 		return success;
 	}
@@ -492,13 +343,36 @@ public:
 	void run() override {
 		bool quit = false;
 		SDL_Event e;
-		Dot greenDot{Dot::DOT_WIDTH / 2, Dot::DOT_HEIGHT / 2};
-		Dot redDot{240, WINDOW_HEIGHT / 2};
+		const SceneEntity* greenDotEntity = scene.findEntity("green_dot");
+		const SceneEntity* redDotEntity = scene.findEntity("red_dot");
+		const SceneLayer* wallLayer = scene.findLayer("walls");
+		if (!greenDotEntity || !redDotEntity || !wallLayer) {
+			printf("Scene is missing the dots or the walls!\n");
+			return;
+		}
+		if (!scene.getTexture(static_cast<Uint32>(greenDotEntity->texture)) || !scene.getTexture(static_cast<Uint32>(redDotEntity->texture))) {
+			printf("Scene dots have no texture!\n");
+			return;
+		}
+		Dot greenDot{greenDotEntity->rect.x, greenDotEntity->rect.y};
+		Dot redDot{redDotEntity->rect.x, redDotEntity->rect.y};
+		std::vector<const SceneEntity*> wallEntities;
 		std::vector<SDL_Rect> walls;
-		walls.emplace_back(SDL_Rect{300, 40, 40, 400});
-		walls.emplace_back(SDL_Rect{140, 40, 40, 200});
-		walls.emplace_back(SDL_Rect{460, 240, 40, 200});
+		for (Uint32 i = 0; i < wallLayer->numEntities; i++) {
+			const SceneEntity* wall = scene.getEntity(wallLayer->firstEntity + i);
+			if (!wall) {
+				printf("Scene walls reference missing entities!\n");
+				return;
+			}
+			wallEntities.push_back(wall);
+			// Entities without a collider store -1, which no getter accepts.
+			const SceneCollider* collider = scene.getCollider(static_cast<Uint32>(wall->collider));
+			if (collider) {
+				walls.push_back(collider->bounds);
+			}
+		}
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
@@ -507,21 +381,21 @@ public:
 				}
 			}
 			greenDot.move(walls, redDot.getCollider());
-			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-			SDL_RenderClear(renderer);
-			SDL_SetRenderDrawColor(renderer, 0x00, 0x70, 0xC0, 0xFF);
-			SDL_RenderFillRect(renderer, &walls[0]);
-			SDL_RenderFillRect(renderer, &walls[1]);
-			SDL_RenderFillRect(renderer, &walls[2]);
-			greenDot.render(renderer, &greenDotTexture);
-			redDot.render(renderer, &redDotTexture);
-			SDL_RenderPresent(renderer);
+			TiledRenderer::setDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			TiledRenderer::clear(renderer);
+			for (const SceneEntity* wall : wallEntities) {
+				TiledRenderer::setDrawColor(renderer, wall->color.r, wall->color.g, wall->color.b, wall->color.a);
+				TiledRenderer::fillRect(renderer, &wall->rect);
+			}
+			greenDot.render(renderer, &textures[greenDotEntity->texture]);
+			redDot.render(renderer, &textures[redDotEntity->texture]);
+			TiledRenderer::present(renderer);
 		}
 	}
 
 	void close() override {
-		greenDotTexture.free();
-		redDotTexture.free();
+		textures.clear();
+		scene.close();
 		BasicTestBase::close();
 	}
 
@@ -530,13 +404,128 @@ public:
 	}
 
 private:
-	Texture greenDotTexture;
-	Texture redDotTexture;
+	Scene scene;
+	std::vector<Texture> textures;
+};
+
+}
+
+namespace entity_swarm {
+
+struct TestMotion : public BasicTestBase {
+public:
+	bool loadMedia() override {
+		bool success = true;
+		if (!dotTexture.loadFromFile(renderer, "image/green_dot.png")) {
+			printf("Failed to load \"green_dot\" texture image!\n");
+			success = false;
+		}
+		if (!obstacleTexture.loadFromFile(renderer, "image/red_dot.png")) {
+			printf("Failed to load \"red_dot\" texture image!\n");
+			success = false;
+		}
+		for (int i = 0; i < NUM_PARTICLE_TYPES; i++) {
+			std::string path = "image/particle_" + std::to_string(i) + ".png";
+			if (!particleTextures[i].loadFromFile(renderer, path)) {
+				printf("Failed to load \"particle_%d\" texture image!\n", i);
+				success = false;
+			}
+		}
+		return success;
+	}
+
+	void run() override {
+		store.setBounds(screen);
+		for (int i = 0; i < NUM_PARTICLES; i++) {
+			Entity particle = store.create(rand() % (WINDOW_WIDTH - PARTICLE_SIZE), rand() % (WINDOW_HEIGHT - PARTICLE_SIZE), PARTICLE_SIZE, PARTICLE_SIZE, &particleTextures[i % NUM_PARTICLE_TYPES], ENTITY_FLAG_BOUNCE);
+			store.setVelocity(particle, randomVelocity(), randomVelocity());
+		}
+		for (int i = 0; i < NUM_OBSTACLES; i++) {
+			int x = (i % 4 + 1) * WINDOW_WIDTH / 5 - DOT_WIDTH / 2;
+			int y = (i / 4 + 1) * WINDOW_HEIGHT / 3 - DOT_HEIGHT / 2;
+			store.create(x, y, DOT_WIDTH, DOT_HEIGHT, &obstacleTexture, ENTITY_FLAG_SOLID, DOT_LAYER);
+		}
+		dot = store.create(0, 0, DOT_WIDTH, DOT_HEIGHT, &dotTexture, ENTITY_FLAG_SOLID, DOT_LAYER);
+		runSimulation(STEPS_PER_SECOND);
+	}
+
+	void simulate(std::vector<SDL_Event>& events) override {
+		for (SDL_Event& e : events) {
+			store.handleEvent(dot, e, DOT_VEL);
+		}
+		Uint64 start = SDL_GetPerformanceCounter();
+		store.move();
+		store.collide();
+		store.snapshot(snapshots.getWriteBuffer());
+		snapshots.publish();
+		simulationTicks += SDL_GetPerformanceCounter() - start;
+		numSteps++;
+	}
+
+	void renderSnapshot() override {
+		snapshots.acquire();
+		TiledRenderer::setDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+		TiledRenderer::clear(renderer);
+		snapshots.getReadBuffer().record(renderQueue, screen);
+		renderQueue.submit(renderer);
+		TiledRenderer::present(renderer);
+	}
+
+	void close() override {
+		if (numSteps > 0) {
+			double milliseconds = static_cast<double>(simulationTicks) * 1000.0 / SDL_GetPerformanceFrequency() / numSteps;
+			printf("Entity swarm: %d entities, %llu steps, %.3f ms simulating per step\n", store.getNumEntities(), static_cast<unsigned long long>(numSteps), milliseconds);
+		}
+		renderQueue.printStatistics();
+		store.clear();
+		dotTexture.free();
+		obstacleTexture.free();
+		for (int i = 0; i < NUM_PARTICLE_TYPES; i++) {
+			particleTextures[i].free();
+		}
+		BasicTestBase::close();
+	}
+
+	std::string name() override {
+		return "Test Entity Swarm";
+	}
+
+private:
+	int randomVelocity() {
+		int velocity = rand() % MAX_PARTICLE_VEL + 1;
+		return rand() % 2 ? velocity : -velocity;
+	}
+
+private:
+	static constexpr int NUM_PARTICLES = 100000;
+	static constexpr int NUM_OBSTACLES = 8;
+	static constexpr int NUM_PARTICLE_TYPES = 3;
+	static constexpr int PARTICLE_SIZE = 5;
+	static constexpr int MAX_PARTICLE_VEL = 3;
+	static constexpr int STEPS_PER_SECOND = 60;
+	static constexpr Uint8 DOT_LAYER = 1;
+	static constexpr int DOT_WIDTH = 20;
+	static constexpr int DOT_HEIGHT = 20;
+	static constexpr int DOT_VEL = 10;
+
+	Texture dotTexture;
+	Texture obstacleTexture;
+	Texture particleTextures[NUM_PARTICLE_TYPES];
+	SDL_Rect screen{0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
+	EntityStore store;
+	Entity dot = 0;
+	TripleBuffer<EntitySnapshot> snapshots;
+	RenderQueue renderQueue;
+	Uint64 simulationTicks = 0;
+	Uint64 numSteps = 0;
 };
 
 }
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	{
 		collision_detection::TestMotion mainWindow;
 		mainWindow.test();
@@ -549,5 +538,9 @@ int main(int argc, char** argv) {
 		circular_collision_detection::TestMotion mainWindow;
 		mainWindow.test();
 	}
+	{
+		entity_swarm::TestMotion mainWindow;
+		mainWindow.test();
+	}
 	return 0;
 }
\ No newline at end of file
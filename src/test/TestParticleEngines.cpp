@@ -1,5 +1,6 @@
 #include <util/TestBase.h>
 #include <core/Texture.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 #include <vector>
 #include <math.h>
@@ -75,6 +76,7 @@ public:
 		Dot dot{this};
 		SDL_Rect wall;
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
@@ -83,10 +85,10 @@ public:
 				}
 			}
 			dot.move(wall);
-			SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
-			SDL_RenderClear(renderer);
+			TiledRenderer::setDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+			TiledRenderer::clear(renderer);
 			dot.render(renderer, &dotTexture);
-			SDL_RenderPresent(renderer);
+			TiledRenderer::present(renderer);
 		}
 	}
 
@@ -214,6 +216,9 @@ void Dot::render(SDL_Renderer* renderer, Texture* dotTexture) {
 }
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	TestParticleEngines mainWindow;
 	mainWindow.test();
 	return 0;
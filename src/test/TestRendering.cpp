@@ -1,6 +1,13 @@
 #include <util/TestBase.h>
 #include <core/Texture.h>
 #include <core/Button.h>
+#include <core/WidgetManager.h>
+#include <core/RetainedUI.h>
+#include <core/RenderLayer.h>
+#include <core/RenderGraph.h>
+#include <core/EventBus.h>
+#include <core/AssetPack.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 
 const int BUTTON_WIDTH = 40;
@@ -36,7 +43,7 @@ public:
 			success = false;
 		}
 		
-		font = TTF_OpenFont("font/crackman.ttf", 60);
+		font = TTF_OpenFontRW(AssetPack::openFile("font/crackman.ttf"), 1, 60);
 		if (!font) {
 			printf("Failed to load \"crackman\" font! Error: %s\n", TTF_GetError());
 			success = false;
@@ -60,120 +67,184 @@ public:
 				buttonClips[i].w = WIDTH;
 				buttonClips[i].h = HEIGHT;
 			}
+			widgets.init(WINDOW_WIDTH, WINDOW_HEIGHT);
+			ui.init(renderer, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_Color{0x00, 0x00, 0x00, 0x00});
 			for (int i = 0; i < NUM_BUTTONS; i++) {
 				buttons[i].setSize(BUTTON_WIDTH, BUTTON_HEIGHT);
 				buttons[i].setPosition(130 + i * 120, 440);
+				widgets.add(&buttons[i]);
+				buttonWidgets[i] = ui.addWidget(buttons[i].getRect(), [this, i](SDL_Renderer* renderer, int, int) {
+					buttonSpriteSheetTexture.render(renderer, 0, 0, &buttonClips[buttons[i].getSprite()]);
+				});
 			}
 		}
 
+		backgroundLayer.init(renderer, WINDOW_WIDTH, WINDOW_HEIGHT, [this](SDL_Renderer* renderer) {
+			backgroundTexture.setColor(backgroundColor.r, backgroundColor.g, backgroundColor.b);
+			backgroundTexture.render(renderer, 0, 0);
+			nameTexture.render(renderer, 320, 180);
+		}, SDL_BLENDMODE_NONE);
+		renderGraph.init(renderer);
+
 		return success;
 	}
 
 	void run() override {
 		bool quit = false;
-		SDL_Event e;
 		Uint8 r = 255, g = 255, b = 255;
 		Uint8 a = 255;
 		double angle = 0;
 		SDL_RendererFlip flip = SDL_FLIP_NONE;
-		while (!quit) {
-			while (SDL_PollEvent(&e) != 0) {
-				if (e.type == SDL_QUIT) {
-					quit = true;
-				} else if (e.type == SDL_KEYDOWN) {
-					switch (e.key.keysym.sym) {
-						case SDLK_q: {
-							r += 15;
-							break;
-						}
-						case SDLK_w: {
-							g += 15;
-							break;
-						}
-						case SDLK_e: {
-							b += 15;
-							break;
-						}
-						case SDLK_r: {
-							r -= 15;
-							break;
-						}
-						case SDLK_t: {
-							g -= 15;
-							break;
-						}
-						case SDLK_y: {
-							b -= 15;
-							break;
-						}
-						case SDLK_a: {
-							if (a + 32 > 255) {
-								a = 255;
-							} else {
-								a += 32;
-							}
-							break;
-						}
-						case SDLK_s: {
-							if (a - 32 < 0) {
-								a = 0;
-							}
-							else {
-								a -= 32;
-							}
-							break;
-						}
-						case SDLK_1: {
-							angle += 60;
-							break;
-						}
-						case SDLK_2: {
-							angle -= 60;
-							break;
-						}
-						case SDLK_3: {
-							flip = SDL_FLIP_NONE;
-							break;
-						}
-						case SDLK_4: {
-							flip = SDL_FLIP_HORIZONTAL;
-							break;
-						}
-						case SDLK_5: {
-							flip = SDL_FLIP_VERTICAL;
-							break;
-						}
-						default: {
-							break;
-						}
+		EventBus events;
+		events.subscribe(SDL_QUIT, [&](SDL_Event&) {
+			quit = true;
+		});
+		for (Uint32 type : {SDL_RENDER_TARGETS_RESET, SDL_RENDER_DEVICE_RESET}) {
+			events.subscribe(type, [&](SDL_Event& e) {
+				ui.handleEvent(e);
+				backgroundLayer.handleEvent(e);
+				// Target contents are gone, so the frame must be drawn again.
+				invalidate();
+			});
+		}
+		events.subscribe(SDL_KEYDOWN, [&](SDL_Event& e) {
+			switch (e.key.keysym.sym) {
+				case SDLK_q: {
+					r += 15;
+					break;
+				}
+				case SDLK_w: {
+					g += 15;
+					break;
+				}
+				case SDLK_e: {
+					b += 15;
+					break;
+				}
+				case SDLK_r: {
+					r -= 15;
+					break;
+				}
+				case SDLK_t: {
+					g -= 15;
+					break;
+				}
+				case SDLK_y: {
+					b -= 15;
+					break;
+				}
+				case SDLK_a: {
+					if (a + 32 > 255) {
+						a = 255;
+					} else {
+						a += 32;
+					}
+					break;
+				}
+				case SDLK_s: {
+					if (a - 32 < 0) {
+						a = 0;
 					}
-				} else {
-					for (int i = 0; i < NUM_BUTTONS; i++) {
-						buttons[i].handleEvent(&e);
+					else {
+						a -= 32;
 					}
+					break;
+				}
+				case SDLK_1: {
+					angle += 60;
+					break;
+				}
+				case SDLK_2: {
+					angle -= 60;
+					break;
+				}
+				case SDLK_3: {
+					flip = SDL_FLIP_NONE;
+					break;
+				}
+				case SDLK_4: {
+					flip = SDL_FLIP_HORIZONTAL;
+					break;
+				}
+				case SDLK_5: {
+					flip = SDL_FLIP_VERTICAL;
+					break;
+				}
+				default: {
+					break;
 				}
 			}
-			SDL_SetRenderDrawColor(renderer, 0x59, 0x59, 0x59, 0xFF);
-			SDL_RenderClear(renderer);
-			backgroundTexture.setColor(r, g, b);
-			backgroundTexture.render(renderer, 0, 0);
-			nameTexture.render(renderer, 320, 180);
-			sunTexture.setColor(r, g, b);
-			sunTexture.render(renderer, WINDOW_WIDTH - 100, 10, nullptr, angle, nullptr, flip);
-			characterSpriteSheetTexture.setColor(r, g, b);
-			characterSpriteSheetTexture.setAlpha(a);
-			characterSpriteSheetTexture.render(renderer, 100, 280, &characterClips[0]);
-			characterSpriteSheetTexture.render(renderer, 220, 280, &characterClips[1]);
-			characterSpriteSheetTexture.render(renderer, 340, 278, &characterClips[2]);
-			characterSpriteSheetTexture.render(renderer, 460, 278, &characterClips[3]);
-			for (int i = 0; i < NUM_BUTTONS; i++) {
-				buttons[i].render(renderer, &buttonSpriteSheetTexture, buttonClips);
+		});
+		for (Uint32 type : {SDL_MOUSEMOTION, SDL_MOUSEBUTTONDOWN, SDL_MOUSEBUTTONUP}) {
+			events.subscribe(type, [&](SDL_Event& e) {
+				Button* previous = widgets.getHovered();
+				widgets.handleEvent(e);
+				if (previous) {
+					ui.invalidate(buttonWidgets[previous - buttons]);
+				}
+				if (widgets.getHovered()) {
+					ui.invalidate(buttonWidgets[widgets.getHovered() - buttons]);
+				}
+			});
+		}
+		while (!quit) {
+			InputRecorder::frame();
+			bool draw = waitForFrame();
+			events.dispatch();
+			ui.update();
+			if (backgroundColor.r != r || backgroundColor.g != g || backgroundColor.b != b) {
+				backgroundColor = SDL_Color{r, g, b, 0xFF};
+				backgroundLayer.invalidate();
+			}
+			if (!draw) {
+				continue;
+			}
+			renderGraph.addPass("scene", {}, RENDER_GRAPH_BACKBUFFER, [&](SDL_Renderer* renderer) {
+				TiledRenderer::setDrawColor(renderer, 0x59, 0x59, 0x59, 0xFF);
+				TiledRenderer::clear(renderer);
+				backgroundLayer.render();
+				sunTexture.setColor(r, g, b);
+				sunTexture.render(renderer, WINDOW_WIDTH - 100, 10, nullptr, angle, nullptr, flip);
+			});
+			if (renderGraph.supportsTargets()) {
+				// The characters are drawn opaque into their own target and faded as
+				// one image. With alpha at zero the composite is left out, and the
+				// graph culls the offscreen pass along with it.
+				RenderGraphResource characters = renderGraph.createTarget(WINDOW_WIDTH, WINDOW_HEIGHT);
+				renderGraph.addPass("characters", {}, characters, [&](SDL_Renderer*) {
+					characterSpriteSheetTexture.setColor(r, g, b);
+					characterSpriteSheetTexture.setAlpha(0xFF);
+					characterSpriteSheetTexture.setBlendMode(SDL_BLENDMODE_NONE);
+					renderCharacters();
+					characterSpriteSheetTexture.setBlendMode(SDL_BLENDMODE_BLEND);
+				});
+				if (a > 0) {
+					renderGraph.addPass("characters composite", {characters}, RENDER_GRAPH_BACKBUFFER, [&, characters](SDL_Renderer* renderer) {
+						SDL_Texture* texture = renderGraph.getTexture(characters);
+						SDL_SetTextureAlphaMod(texture, a);
+						SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+					});
+				}
+			} else {
+				renderGraph.addPass("characters", {}, RENDER_GRAPH_BACKBUFFER, [&](SDL_Renderer*) {
+					characterSpriteSheetTexture.setColor(r, g, b);
+					characterSpriteSheetTexture.setAlpha(a);
+					renderCharacters();
+				});
 			}
-			SDL_RenderPresent(renderer);
+			renderGraph.addPass("ui", {}, RENDER_GRAPH_BACKBUFFER, [&](SDL_Renderer*) {
+				ui.render();
+			});
+			renderGraph.execute();
+			TiledRenderer::present(renderer);
 		}
 	}
 
 	void close() override {
+		renderGraph.printStatistics();
+		renderGraph.free();
+		backgroundLayer.free();
+		ui.free();
 		characterSpriteSheetTexture.free();
 		sunTexture.free();
 		nameTexture.free();
@@ -187,6 +258,14 @@ public:
 		return "Test Rendering";
 	}
 
+private:
+	void renderCharacters() {
+		characterSpriteSheetTexture.render(renderer, 100, 280, &characterClips[0]);
+		characterSpriteSheetTexture.render(renderer, 220, 280, &characterClips[1]);
+		characterSpriteSheetTexture.render(renderer, 340, 278, &characterClips[2]);
+		characterSpriteSheetTexture.render(renderer, 460, 278, &characterClips[3]);
+	}
+
 private:
 	static constexpr int NUM_CHARACTERS = 4;
 	static constexpr int NUM_BUTTONS = 4;
@@ -198,14 +277,23 @@ private:
 	Texture sunTexture;
 	Texture nameTexture;
 	Texture backgroundTexture;
+	SDL_Color backgroundColor{0xFF, 0xFF, 0xFF, 0xFF};
+	RenderLayer backgroundLayer;
+	RenderGraph renderGraph;
 
 	SDL_Rect buttonClips[NUM_BUTTONS];
 	Button buttons[NUM_BUTTONS];
+	WidgetManager widgets;
+	RetainedUI ui;
+	int buttonWidgets[NUM_BUTTONS];
 	Texture buttonSpriteSheetTexture;
 };
 
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	TestRendering mainWindow;
 	mainWindow.test();
 	return 0;
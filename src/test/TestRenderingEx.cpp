@@ -1,48 +1,39 @@
 #include <util/TestBase.h>
 #include <core/Texture.h>
+#include <core/AssetLoader.h>
+#include <core/Animator.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 
 struct TestRenderingEx : public BasicTestBase {
 public:
 	bool loadMedia() override {
-		bool success = true;
+		const std::vector<std::string> paths = {
+			"image/animated_character.png",
+			"image/background.png",
+			"image/up_background.png",
+			"image/down_background.png",
+			"image/left_background.png",
+			"image/right_background.png",
+		};
+		const std::vector<Texture*> textures = {
+			&spriteSheetTexture,
+			&backgroundTexture,
+			&upBackgroundTexture,
+			&downBackgroundTexture,
+			&leftBackgroundTexture,
+			&rightBackgroundTexture,
+		};
 
-		if (!spriteSheetTexture.loadFromFile(renderer, "image/animated_character.png")) {
-			printf("Failed to load \"animated_character\" texture image!\n");
-			success = false;
-		} else {
-			const int WIDTH = 104;
-			const int HEIGHT = 147;
-			for (int i = 0; i < NUM_FRAMES; i++) {
-				spriteClips[i].x = i * WIDTH;
-				spriteClips[i].y = 0;
-				spriteClips[i].w = 104;
-				spriteClips[i].h = 147;
-			}
-		}
-
-		if (!backgroundTexture.loadFromFile(renderer, "image/background.png")) {
-			printf("Failed to load \"background\" texture image!\n");
-			success = false;
-		}
-
-		if (!upBackgroundTexture.loadFromFile(renderer, "image/up_background.png")) {
-			printf("Failed to load \"up_background\" texture image!\n");
-			success = false;
-		}
-
-		if (!downBackgroundTexture.loadFromFile(renderer, "image/down_background.png")) {
-			printf("Failed to load \"down_background\" texture image!\n");
-			success = false;
-		}
+		AssetLoader loader;
+		bool success = loader.init() && loader.loadTextures(renderer, paths, textures);
+		loader.free();
 
-		if (!leftBackgroundTexture.loadFromFile(renderer, "image/left_background.png")) {
-			printf("Failed to load \"left_background\" texture image!\n");
+		if (!animations.load("animation/animated_character.txt")) {
+			printf("Failed to load \"animated_character\" animations! Error: %s\n", SDL_GetError());
 			success = false;
-		}
-
-		if (!rightBackgroundTexture.loadFromFile(renderer, "image/right_background.png")) {
-			printf("Failed to load \"right_background\" texture image!\n");
+		} else if (animations.findClip("walk") < 0) {
+			printf("Animations are missing the \"walk\" clip!\n");
 			success = false;
 		}
 
@@ -52,9 +43,15 @@ public:
 	void run() override {
 		bool quit = false;
 		SDL_Event e;
-		int frame = 0;
 		Texture* currentBackgroundTexture = nullptr;
+		animator.init(&animations);
+		AnimationInstance walk = animator.play(animations.findClip("walk"), &spriteSheetTexture, 360, 280);
+		bool walking = true;
+		setAnimating(walking);
+		Uint32 lastTicks = SDL_GetTicks();
 		while (!quit) {
+			InputRecorder::frame();
+			bool draw = waitForFrame();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
@@ -72,19 +69,35 @@ public:
 			} else {
 				currentBackgroundTexture = &backgroundTexture;
 			}
-			SDL_SetRenderDrawColor(renderer, 0x59, 0x59, 0x59, 0xFF);
-			SDL_RenderClear(renderer);
-			currentBackgroundTexture->render(renderer, 0, 0);
-			spriteSheetTexture.render(renderer, 360, 280, &spriteClips[frame / 12]);
-			frame++;
-			if (frame / 12 >= NUM_FRAMES) {
-				frame = 0;
+			Uint32 ticks = SDL_GetTicks();
+			animator.update(ticks - lastTicks);
+			lastTicks = ticks;
+			for (auto& event : animator.getEvents()) {
+				if (*event.marker == "step") {
+					numSteps++;
+				}
+			}
+			// A walk clip that does not loop stops redrawing once it is done;
+			// after that only input wakes the loop.
+			if (walking != (animator.isPlaying(walk) && !animator.isFinished(walk))) {
+				walking = !walking;
+				setAnimating(walking);
+			}
+			if (!draw) {
+				continue;
 			}
-			SDL_RenderPresent(renderer);
+			TiledRenderer::setDrawColor(renderer, 0x59, 0x59, 0x59, 0xFF);
+			TiledRenderer::clear(renderer);
+			currentBackgroundTexture->render(renderer, 0, 0);
+			animator.render(renderer);
+			TiledRenderer::present(renderer);
 		}
 	}
 
 	void close() override {
+		printf("Character took %d steps\n", numSteps);
+		animator.clear();
+		animations.clear();
 		spriteSheetTexture.free();
 		backgroundTexture.free();
 		BasicTestBase::close();
@@ -95,8 +108,9 @@ public:
 	}
 
 private:
-	static constexpr int NUM_FRAMES = 4;
-	SDL_Rect spriteClips[NUM_FRAMES];
+	AnimationSet animations;
+	Animator animator;
+	int numSteps = 0;
 	Texture spriteSheetTexture;
 	Texture backgroundTexture;
 	Texture upBackgroundTexture;
@@ -107,6 +121,9 @@ private:
 
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	TestRenderingEx mainWindow;
 	mainWindow.test();
 	return 0;
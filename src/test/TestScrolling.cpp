@@ -1,5 +1,9 @@
 #include <util/TestBase.h>
 #include <core/Texture.h>
+#include <core/VoiceManager.h>
+#include <core/AssetPack.h>
+#include <core/EntityStore.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 #include <vector>
 #include <math.h>
@@ -9,90 +13,20 @@ const int LEVEL_HEIGHT = 720;
 
 namespace test_scrolling {
 
-struct Dot {
+struct TestScrolling : public BasicTestBaseWithAudio {
 public:
-	static constexpr int DOT_WIDTH = 20;
-	static constexpr int DOT_HEIGHT = 20;
-	static constexpr int DOT_VEL = 10;
-
-	Dot() {
-		posX = 0;
-		posY = 0;
-		velX = 0;
-		velY = 0;
-	}
-
-	void handleEvent(SDL_Event& e) {
-		if (e.type == SDL_KEYDOWN && e.key.repeat == 0) {
-			switch (e.key.keysym.sym) {
-				case SDLK_UP: {
-					velY -= DOT_VEL; break;
-				}
-				case SDLK_DOWN: {
-					velY += DOT_VEL; break;
-				}
-				case SDLK_LEFT: {
-					velX -= DOT_VEL; break;
-				}
-				case SDLK_RIGHT: {
-					velX += DOT_VEL; break;
-				}
-				default: {
-					break;
-				}
-			}
-		}
-		else if (e.type == SDL_KEYUP && e.key.repeat == 0) {
-			switch (e.key.keysym.sym) {
-				case SDLK_UP: {
-					velY += DOT_VEL; break;
-				}
-				case SDLK_DOWN: {
-					velY -= DOT_VEL; break;
-				}
-				case SDLK_LEFT: {
-					velX += DOT_VEL; break;
-				}
-				case SDLK_RIGHT: {
-					velX -= DOT_VEL; break;
-				}
-				default: {
-					break;
-				}
-			}
-		}
-	}
-
-	void move() {
-		posX += velX;
-		if (posX < 0 || posX + DOT_WIDTH > LEVEL_WIDTH) {
-			posX -= velX;
-		}
-		posY += velY;
-		if (posY < 0 || posY + DOT_HEIGHT > LEVEL_HEIGHT) {
-			posY -= velY;
+	bool init() override {
+		bool success = BasicTestBaseWithAudio::init();
+		if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
+			printf("SDL_mixer could not initialize! Error: %s\n", Mix_GetError());
+			success = false;
+		} else if (!voiceManager.init(NUM_VOICES, HEARING_DISTANCE)) {
+			printf("Failed to initialize voice manager!\n");
+			success = false;
 		}
+		return success;
 	}
 
-	void render(SDL_Renderer* renderer, Texture* dotTexture, SDL_Point cam) {
-		dotTexture->render(renderer, posX - cam.x, posY - cam.y);
-	}
-
-	int getPosX() {
-		return posX;
-	}
-
-	int getPosY() {
-		return posY;
-	}
-
-private:
-	int posX, posY;
-	int velX, velY;
-};
-
-struct TestScrolling : public BasicTestBase {
-public:
 	bool loadMedia() override {
 		bool success = true;
 		if (!dotTexture.loadFromFile(renderer, "image/red_dot.png")) {
@@ -103,26 +37,42 @@ public:
 			printf("Failed to load \"background2\" texture image!\n");
 			success = false;
 		}
+		soundEffect = Mix_LoadWAV_RW(AssetPack::openFile("sound/kitty.wav"), 1);
+		if (!soundEffect) {
+			printf("Failed to load \"kitty\" sound effect! Error: %s\n", Mix_GetError());
+			success = false;
+		} else {
+			for (int i = 0; i < NUM_EMITTERS; i++) {
+				int emitterId = voiceManager.createEmitter(soundEffect, i % 2, true);
+				voiceManager.setEmitterPosition(emitterId, (i % 8) * LEVEL_WIDTH / 8 + LEVEL_WIDTH / 16, (i / 8) * LEVEL_HEIGHT / 4 + LEVEL_HEIGHT / 8);
+				voiceManager.start(emitterId);
+			}
+		}
 		return success;
 	}
 
 	void run() override {
 		bool quit = false;
 		SDL_Event e;
-		Dot dot;
+		EntityStore store;
+		store.setBounds({0, 0, LEVEL_WIDTH, LEVEL_HEIGHT});
+		Entity dot = store.create(0, 0, DOT_WIDTH, DOT_HEIGHT, &dotTexture);
 		SDL_Rect cam{0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
 				}
 				else {
-					dot.handleEvent(e);
+					store.handleEvent(dot, e, DOT_VEL);
 				}
 			}
-			dot.move();
-			cam.x = (dot.getPosX() - Dot::DOT_WIDTH / 2) - WINDOW_WIDTH / 2;
-			cam.y = (dot.getPosY() - Dot::DOT_HEIGHT / 2) - WINDOW_HEIGHT / 2;
+			store.move();
+			voiceManager.setListenerPosition(store.getPosX(dot) + DOT_WIDTH / 2, store.getPosY(dot) + DOT_HEIGHT / 2);
+			voiceManager.update();
+			cam.x = (store.getPosX(dot) - DOT_WIDTH / 2) - WINDOW_WIDTH / 2;
+			cam.y = (store.getPosY(dot) - DOT_HEIGHT / 2) - WINDOW_HEIGHT / 2;
 			if (cam.x < 0) {
 				cam.x = 0;
 			}
@@ -135,19 +85,23 @@ public:
 			if (cam.y > LEVEL_HEIGHT - cam.h) {
 				cam.y = LEVEL_HEIGHT - cam.h;
 			}
-			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-			SDL_RenderClear(renderer);
-			SDL_SetRenderDrawColor(renderer, 0xC0, 0x00, 0x00, 0xFF);
+			TiledRenderer::setDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			TiledRenderer::clear(renderer);
+			TiledRenderer::setDrawColor(renderer, 0xC0, 0x00, 0x00, 0xFF);
 			backgroundTexture.render(renderer, 0, 0, &cam);
-			dot.render(renderer, &dotTexture, {cam.x, cam.y});
-			SDL_RenderPresent(renderer);
+			store.render(renderer, cam);
+			TiledRenderer::present(renderer);
 		}
 	}
 
 	void close() override {
 		dotTexture.free();
 		backgroundTexture.free();
-		BasicTestBase::close();
+		voiceManager.free();
+		Mix_FreeChunk(soundEffect);
+		soundEffect = nullptr;
+		Mix_CloseAudio();
+		BasicTestBaseWithAudio::close();
 	}
 
 	std::string name() override {
@@ -155,96 +109,23 @@ public:
 	}
 
 private:
+	static constexpr int DOT_WIDTH = 20;
+	static constexpr int DOT_HEIGHT = 20;
+	static constexpr int DOT_VEL = 10;
+	static constexpr int NUM_EMITTERS = 32;
+	static constexpr int NUM_VOICES = 4;
+	static constexpr int HEARING_DISTANCE = 300;
+
 	Texture dotTexture;
 	Texture backgroundTexture;
+	Mix_Chunk* soundEffect = nullptr;
+	VoiceManager voiceManager;
 };
 
 }
 
 namespace test_scrolling_backgrounds {
 
-struct Dot {
-public:
-	static constexpr int DOT_WIDTH = 20;
-	static constexpr int DOT_HEIGHT = 20;
-	static constexpr int DOT_VEL = 10;
-
-	Dot() {
-		posX = 0;
-		posY = 0;
-		velX = 0;
-		velY = 0;
-	}
-
-	void handleEvent(SDL_Event& e) {
-		if (e.type == SDL_KEYDOWN && e.key.repeat == 0) {
-			switch (e.key.keysym.sym) {
-				case SDLK_UP: {
-					velY -= DOT_VEL; break;
-				}
-				case SDLK_DOWN: {
-					velY += DOT_VEL; break;
-				}
-				case SDLK_LEFT: {
-					velX -= DOT_VEL; break;
-				}
-				case SDLK_RIGHT: {
-					velX += DOT_VEL; break;
-				}
-				default: {
-					break;
-				}
-			}
-		}
-		else if (e.type == SDL_KEYUP && e.key.repeat == 0) {
-			switch (e.key.keysym.sym) {
-				case SDLK_UP: {
-					velY += DOT_VEL; break;
-				}
-				case SDLK_DOWN: {
-					velY -= DOT_VEL; break;
-				}
-				case SDLK_LEFT: {
-					velX += DOT_VEL; break;
-				}
-				case SDLK_RIGHT: {
-					velX -= DOT_VEL; break;
-				}
-				default: {
-					break;
-				}
-			}
-		}
-	}
-
-	void move() {
-		posX += velX;
-		if (posX < 0 || posX + DOT_WIDTH > LEVEL_WIDTH) {
-			posX -= velX;
-		}
-		posY += velY;
-		if (posY < 0 || posY + DOT_HEIGHT > LEVEL_HEIGHT) {
-			posY -= velY;
-		}
-	}
-
-	void render(SDL_Renderer* renderer, Texture* dotTexture) {
-		dotTexture->render(renderer, posX, posY);
-	}
-
-	int getPosX() {
-		return posX;
-	}
-
-	int getPosY() {
-		return posY;
-	}
-
-private:
-	int posX, posY;
-	int velX, velY;
-};
-
 struct TestScrolling : public BasicTestBase {
 public:
 	bool loadMedia() override {
@@ -263,29 +144,33 @@ public:
 	void run() override {
 		bool quit = false;
 		SDL_Event e;
-		Dot dot;
+		SDL_Rect screen{0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
+		EntityStore store;
+		store.setBounds({0, 0, LEVEL_WIDTH, LEVEL_HEIGHT});
+		Entity dot = store.create(0, 0, DOT_WIDTH, DOT_HEIGHT, &dotTexture);
 		int scrollingOffset = 0;
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
 				}
 				else {
-					dot.handleEvent(e);
+					store.handleEvent(dot, e, DOT_VEL);
 				}
 			}
-			dot.move();
+			store.move();
 			scrollingOffset--;
 			if (scrollingOffset < -WINDOW_WIDTH) {
 				scrollingOffset = 0;
 			}
-			SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-			SDL_RenderClear(renderer);
-			SDL_SetRenderDrawColor(renderer, 0xC0, 0x00, 0x00, 0xFF);
+			TiledRenderer::setDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			TiledRenderer::clear(renderer);
+			TiledRenderer::setDrawColor(renderer, 0xC0, 0x00, 0x00, 0xFF);
 			backgroundTexture.render(renderer, scrollingOffset, 0);
 			backgroundTexture.render(renderer, scrollingOffset + WINDOW_WIDTH, 0);
-			dot.render(renderer, &dotTexture);
-			SDL_RenderPresent(renderer);
+			store.render(renderer, screen);
+			TiledRenderer::present(renderer);
 		}
 	}
 
@@ -300,6 +185,10 @@ public:
 	}
 
 private:
+	static constexpr int DOT_WIDTH = 20;
+	static constexpr int DOT_HEIGHT = 20;
+	static constexpr int DOT_VEL = 10;
+
 	Texture dotTexture;
 	Texture backgroundTexture;
 };
@@ -307,6 +196,9 @@ private:
 }
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	{
 		test_scrolling::TestScrolling mainWindow;
 		mainWindow.test();
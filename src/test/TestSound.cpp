@@ -1,5 +1,8 @@
 #include <util/TestBase.h>
 #include <core/Texture.h>
+#include <core/VoiceManager.h>
+#include <core/AssetPack.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 
 struct TestSound : public BasicTestBaseWithAudio {
@@ -9,6 +12,9 @@ public:
 		if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
 			printf("SDL_mixer could not initialize! Error: %s\n", Mix_GetError());
 			success = false;
+		} else if (!voiceManager.init(NUM_VOICES, HEARING_DISTANCE)) {
+			printf("Failed to initialize voice manager!\n");
+			success = false;
 		}
 		return success;
 	}
@@ -23,12 +29,12 @@ public:
 			printf("Failed to load \"background\" texture image! Error: %s\n", Mix_GetError());
 			success = false;
 		}
-		music = Mix_LoadMUS("sound/nico.wav");
+		music = Mix_LoadMUS_RW(AssetPack::openFile("sound/nico.wav"), 1);
 		if (!music) {
 			printf("Failed to load \"nico\" music! Error: %s\n", Mix_GetError());
 			success = false;
 		}
-		soundEffect = Mix_LoadWAV("sound/kitty.wav");
+		soundEffect = Mix_LoadWAV_RW(AssetPack::openFile("sound/kitty.wav"), 1);
 		if (!soundEffect) {
 			printf("Failed to load \"kitty\" sound effect! Error: %s\n", Mix_GetError());
 			success = false;
@@ -39,14 +45,18 @@ public:
 	void run() override {
 		bool quit = false;
 		SDL_Event e;
+		voiceManager.setListenerPosition(WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2);
 		while (!quit) {
+			InputRecorder::frame();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
 				} else if (e.type == SDL_KEYDOWN) {
 					switch (e.key.keysym.sym) {
 						case SDLK_1: {
-							Mix_PlayChannel(-1, soundEffect, 0);
+							if (!voiceManager.playAt(soundEffect, WINDOW_WIDTH / 2 + 40, WINDOW_HEIGHT / 2 + 40, 0)) {
+								printf("Warning: \"kitty\" sound effect dropped!\n");
+							}
 							break;
 						}
 						case SDLK_9: {
@@ -72,16 +82,18 @@ public:
 					}
 				}
 			}
-			SDL_RenderClear(renderer);
+			voiceManager.update();
+			TiledRenderer::clear(renderer);
 			backgroundTexture.render(renderer, 0, 0);
 			characterTexture.render(renderer, WINDOW_WIDTH / 2 + 40, WINDOW_HEIGHT / 2 + 40);
-			SDL_RenderPresent(renderer);
+			TiledRenderer::present(renderer);
 		}
 	}
 
 	void close() override {
 		characterTexture.free();
 		backgroundTexture.free();
+		voiceManager.free();
 		Mix_FreeChunk(soundEffect);
 		soundEffect = nullptr;
 		Mix_FreeMusic(music);
@@ -94,6 +106,10 @@ public:
 	}
 
 private:
+	static constexpr int NUM_VOICES = 8;
+	static constexpr int HEARING_DISTANCE = 800;
+
+	VoiceManager voiceManager;
 	Texture characterTexture;
 	Texture backgroundTexture;
 
@@ -103,6 +119,9 @@ private:
 
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	TestSound mainWindow;
 	mainWindow.test();
 	return 0;
@@ -1,12 +1,15 @@
 #include <util/TestBase.h>
 #include <core/Texture.h>
+#include <core/RetainedUI.h>
+#include <core/AssetPack.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 
 struct TestTextInput : public BasicTestBaseWithTTF {
 public:
 	bool loadMedia() override {
 		bool success = true;
-		font = TTF_OpenFont("font/prompt.ttf", 16);
+		font = TTF_OpenFontRW(AssetPack::openFile("font/prompt.ttf"), 1, 16);
 		if (!font) {
 			printf("Failed to load \"prompt\" font! Error: %s\n", TTF_GetError());
 			success = false;
@@ -16,6 +19,13 @@ public:
 				printf("Failed to render prompt text texture!\n");
 				success = false;
 			}
+			ui.init(renderer, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_Color{0x00, 0x00, 0x00, 0xFF});
+			ui.addWidget(SDL_Rect{0, 0, promptTextTexture.getWidth(), promptTextTexture.getHeight()}, [this](SDL_Renderer* renderer, int, int) {
+				promptTextTexture.render(renderer, 0, 0);
+			});
+			inputWidget = ui.addWidget(SDL_Rect{100, 0, 0, 0}, [this](SDL_Renderer* renderer, int, int) {
+				inputTextTexture.render(renderer, 0, 0);
+			});
 		}
 		return success;
 	}
@@ -26,9 +36,12 @@ public:
 		SDL_Color textColor{0xFF, 0xFF, 0xFF};
 		std::string inputText = " ";
 		inputTextTexture.loadFromRenderedText(renderer, font, inputText, textColor);
+		ui.setWidgetRect(inputWidget, SDL_Rect{100, 0, inputTextTexture.getWidth(), inputTextTexture.getHeight()});
 		while (!quit) {
+			InputRecorder::frame();
 			bool renderText = false;
 			while (SDL_PollEvent(&e) != 0) {
+				ui.handleEvent(e);
 				if (e.type == SDL_QUIT) {
 					quit = true;
 				} else if (e.type == SDL_KEYDOWN) {
@@ -56,17 +69,17 @@ public:
 				} else {
 					inputTextTexture.loadFromRenderedText(renderer, font, " ", textColor);
 				}
+				ui.setWidgetRect(inputWidget, SDL_Rect{100, 0, inputTextTexture.getWidth(), inputTextTexture.getHeight()});
 			}
-			SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
-			SDL_RenderClear(renderer);
-			promptTextTexture.render(renderer, 0, 0);
-			inputTextTexture.render(renderer, 100, 0);
+			ui.update();
+			ui.render();
 			SDL_RenderPresent(renderer);
 		}
 		SDL_StopTextInput();
 	}
 
 	void close() override {
+		ui.free();
 		inputTextTexture.free();
 		promptTextTexture.free();
 		TTF_CloseFont(font);
@@ -78,13 +91,22 @@ public:
 		return "Test Text Input";
 	}
 
+	bool supportsTiledRenderer() override {
+		return false;
+	}
+
 private:
 	TTF_Font* font = nullptr;
 	Texture inputTextTexture;
 	Texture promptTextTexture;
+	RetainedUI ui;
+	int inputWidget = 0;
 };
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	TestTextInput mainWindow;
 	mainWindow.test();
 	return 0;
@@ -1,6 +1,8 @@
 #include <util/TestBase.h>
 #include <core/Texture.h>
 #include <core/Timer.h>
+#include <core/AssetPack.h>
+#include <util/InputRecorder.h>
 #include <stdio.h>
 #include <sstream>
 #include <iomanip>
@@ -18,13 +20,13 @@ public:
 			success = false;
 		}
 
-		titleFont = TTF_OpenFont("font/crackman.ttf", 60);
+		titleFont = TTF_OpenFontRW(AssetPack::openFile("font/crackman.ttf"), 1, 60);
 		if (!titleFont) {
 			printf("Failed to load \"gasalt\" font! Error: %s\n", TTF_GetError());
 			success = false;
 		}
 
-		timeFont = TTF_OpenFont("font/pixel.ttf", 28);
+		timeFont = TTF_OpenFontRW(AssetPack::openFile("font/pixel.ttf"), 1, 28);
 		if (!timeFont) {
 			printf("Failed to load \"pixel\" font! Error: %s\n", TTF_GetError());
 			success = false;
@@ -41,6 +43,7 @@ public:
 		int nFrames = 0;
 		fpsTimer.start();
 		while (!quit) {
+			InputRecorder::frame();
 			capTimer.start();
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
@@ -85,11 +88,11 @@ public:
 				printf("Failed to render fps texture!\n");
 			}
 
-			SDL_RenderClear(renderer);
+			TiledRenderer::clear(renderer);
 			landscapeTexture.render(renderer, 0, 0);
 			timeTexture.render(renderer, WINDOW_WIDTH - 200, 20);
 			fpsTexture.render(renderer, WINDOW_WIDTH - 200, 45);
-			SDL_RenderPresent(renderer);
+			TiledRenderer::present(renderer);
 
 			nFrames++;
 
@@ -125,6 +128,9 @@ private:
 
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	TestTiming mainWindow;
 	mainWindow.test();
 	return 0;
@@ -1,5 +1,8 @@
 #include <core/Window.h>
+#include <core/PresentScheduler.h>
 #include <core/Texture.h>
+#include <core/EventBus.h>
+#include <util/InputRecorder.h>
 
 struct TestWindow {
 public:
@@ -38,17 +41,27 @@ public:
 		bool quit = false;
 		SDL_Event e;
 		while (!quit) {
+			InputRecorder::frame();
+			// The picture only changes with the window, so the loop sleeps until
+			// an event arrives. Recorded input is timed in frames and keeps the
+			// loop drawing every frame instead.
+			if (InputRecorder::isRecording() || InputRecorder::isReplaying()) {
+				window.invalidate();
+			} else {
+				window.waitForEvent(IDLE_TIMEOUT);
+			}
 			while (SDL_PollEvent(&e) != 0) {
 				if (e.type == SDL_QUIT) {
 					quit = true;
 				}
-				window.handleEvent(e, renderer);
+				window.handleEvent(e);
 			}
-			if (!window.isMinimized()) {
+			if (window.needsRedraw()) {
 				SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
 				SDL_RenderClear(renderer);
 				texture.render(renderer, (window.getWidth() - texture.getWidth()) / 2, (window.getHeight() - texture.getHeight()) / 2);
 				SDL_RenderPresent(renderer);
+				window.validate();
 			}
 		}
 	}
@@ -63,6 +76,8 @@ public:
 	}
 
 private:
+	static constexpr Uint32 IDLE_TIMEOUT = 1000;
+
 	Window window;
 	SDL_Renderer* renderer;
 	Texture texture;
@@ -82,6 +97,8 @@ public:
 			if (!windows[0].init()) {
 				printf("Window 0 could not be created! Error: %s\n", SDL_GetError());
 				success = false;
+			} else {
+				scheduler.add(&windows[0]);
 			}
 		}
 		return success;
@@ -93,29 +110,35 @@ public:
 	}
 
 	void run() {
+		// Only the first window waits for vsync, the scheduler presents it last.
 		for (int i = 1; i < NUM_WINDOWS; i++) {
-			windows[i].init();
+			if (windows[i].init(false)) {
+				scheduler.add(&windows[i]);
+			}
 		}
 		bool quit = false;
-		SDL_Event e;
-		while (!quit) {
-			while (SDL_PollEvent(&e) != 0) {
-				if (e.type == SDL_QUIT) {
-					quit = true;
-				}
-				for (int i = 0; i < NUM_WINDOWS; i++) {
-					windows[i].handleEvent(e);
-				}
-				if (e.type == SDL_KEYDOWN) {
-					auto id = e.key.keysym.sym - SDLK_1;
-					if (id >= 0 && id < NUM_WINDOWS) {
-						windows[id].focus();
-					}
-				}
+		EventBus events;
+		events.subscribe(SDL_QUIT, [&](SDL_Event&) {
+			quit = true;
+		});
+		for (int i = 0; i < NUM_WINDOWS; i++) {
+			WindowEx* window = &windows[i];
+			for (Uint32 type : {SDL_WINDOWEVENT, SDL_KEYDOWN}) {
+				events.subscribe(type, window->getWindowID(), [window](SDL_Event& e) {
+					window->handleEvent(e);
+				});
 			}
-			for (int i = 0; i < NUM_WINDOWS; i++) {
-				windows[i].render();
+		}
+		events.subscribe(SDL_KEYDOWN, [&](SDL_Event& e) {
+			auto id = e.key.keysym.sym - SDLK_1;
+			if (id >= 0 && id < NUM_WINDOWS) {
+				windows[id].focus();
 			}
+		});
+		while (!quit) {
+			InputRecorder::frame();
+			events.dispatch();
+			scheduler.present();
 			bool allClosed = true;
 			for (int i = 0; i < NUM_WINDOWS; i++) {
 				if (windows[i].isShown()) {
@@ -130,6 +153,8 @@ public:
 	}
 
 	void close() {
+		scheduler.printStatistics();
+		scheduler.clear();
 		for (int i = 0; i < NUM_WINDOWS; i++) {
 			windows[i].free();
 		}
@@ -139,6 +164,7 @@ public:
 private:
 	static constexpr int NUM_WINDOWS = 3;
 	WindowEx windows[NUM_WINDOWS];
+	PresentScheduler scheduler;
 };
 
 struct TestMultipleDisplays {
@@ -175,14 +201,18 @@ public:
 
 	void run() {
 		bool quit = false;
-		SDL_Event e;
-		while (!quit) {
-			while (SDL_PollEvent(&e) != 0) {
-				if (e.type == SDL_QUIT) {
-					quit = true;
-				}
+		EventBus events;
+		events.subscribe(SDL_QUIT, [&](SDL_Event&) {
+			quit = true;
+		});
+		for (Uint32 type : {SDL_WINDOWEVENT, SDL_KEYDOWN}) {
+			events.subscribe(type, window.getWindowID(), [this](SDL_Event& e) {
 				window.handleEvent(e);
-			}
+			});
+		}
+		while (!quit) {
+			InputRecorder::frame();
+			events.dispatch();
 			window.render();
 		}
 	}
@@ -206,13 +236,18 @@ private:
 		if (!mainWindow.loadMedia()) { \
 			printf("Failed to load media!\n"); \
 		} else { \
+			InputRecorder::attach(); \
 			mainWindow.run(); \
+			InputRecorder::detach(); \
 		} \
 	} \
 	mainWindow.close(); \
 }
 
 int main(int argc, char** argv) {
+	if (!InputRecorder::parseArguments(argc, argv)) {
+		return 1;
+	}
 	TEST(TestWindow)
 	TEST(TestMultipleWindows)
 	TEST(TestMultipleDisplays)
@@ -0,0 +1,75 @@
+#include <core/CookedTexture.h>
+#include <SDL_image.h>
+#include <stdio.h>
+#include <string.h>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		printf("Usage: %s <resource directory> <output directory> [--rle] [--format ARGB8888|ABGR8888|RGBA8888|BGRA8888]\n", argv[0]);
+		return 1;
+	}
+	fs::path root = argv[1];
+	fs::path output = argv[2];
+	bool compress = false;
+	Uint32 format = SDL_PIXELFORMAT_ARGB8888;
+	for (int i = 3; i < argc; i++) {
+		if (strcmp(argv[i], "--rle") == 0) {
+			compress = true;
+		} else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+			std::string name = std::string("SDL_PIXELFORMAT_") + argv[++i];
+			Uint32 formats[] = {SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_BGRA8888};
+			format = SDL_PIXELFORMAT_UNKNOWN;
+			for (Uint32 candidate : formats) {
+				if (name == SDL_GetPixelFormatName(candidate)) {
+					format = candidate;
+				}
+			}
+			if (format == SDL_PIXELFORMAT_UNKNOWN) {
+				printf("Unsupported pixel format \"%s\"!\n", argv[i]);
+				return 1;
+			}
+		}
+	}
+
+	int imgFlags = IMG_INIT_PNG;
+	if (!(IMG_Init(imgFlags) & imgFlags)) {
+		printf("SDL2_image could not initialize! Error: %s\n", IMG_GetError());
+		return 1;
+	}
+	int numCooked = 0;
+	int numFailed = 0;
+	std::error_code error;
+	for (fs::recursive_directory_iterator it(root, error), end; it != end; it.increment(error)) {
+		if (error || !it->is_regular_file()) {
+			continue;
+		}
+		std::string extension = it->path().extension().string();
+		if (extension != ".png" && extension != ".bmp") {
+			continue;
+		}
+		std::string name = it->path().lexically_relative(root).generic_string();
+		fs::path target = output / CookedTexture::getCookedPath(name);
+		fs::create_directories(target.parent_path(), error);
+		SDL_Surface* loadedSurface = IMG_Load(it->path().string().c_str());
+		if (!loadedSurface) {
+			printf("Unable to load image %s! Error: %s\n", name.c_str(), IMG_GetError());
+			numFailed++;
+			continue;
+		}
+		SDL_Surface* bakedSurface = CookedTexture::bake(loadedSurface, format);
+		SDL_FreeSurface(loadedSurface);
+		if (!bakedSurface || !CookedTexture::save(bakedSurface, target.string(), compress)) {
+			printf("Unable to cook image %s! Error: %s\n", name.c_str(), SDL_GetError());
+			numFailed++;
+		} else {
+			numCooked++;
+		}
+		SDL_FreeSurface(bakedSurface);
+	}
+	IMG_Quit();
+	printf("Cooked %d textures into \"%s\" (%d failed)!\n", numCooked, output.string().c_str(), numFailed);
+	return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+#include <core/AssetPack.h>
+#include <stdio.h>
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct PackedAsset {
+	std::string name;
+	fs::path path;
+	PackEntry entry;
+};
+
+Uint64 align(Uint64 offset) {
+	return (offset + AssetPack::PACK_ALIGNMENT - 1) / AssetPack::PACK_ALIGNMENT * AssetPack::PACK_ALIGNMENT;
+}
+
+bool writePadding(SDL_RWops* file, Uint64 offset) {
+	static const Uint8 zeros[AssetPack::PACK_ALIGNMENT] = {};
+	Uint64 padding = align(offset) - offset;
+	return padding == 0 || SDL_RWwrite(file, zeros, static_cast<size_t>(padding), 1) == 1;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		printf("Usage: %s <resource directory> <output pack>\n", argv[0]);
+		return 1;
+	}
+	fs::path root = argv[1];
+	fs::path output = fs::absolute(argv[2]);
+
+	std::vector<PackedAsset> assets;
+	std::error_code error;
+	for (fs::recursive_directory_iterator it(root, error), end; it != end; it.increment(error)) {
+		if (error || !it->is_regular_file() || fs::absolute(it->path()) == output) {
+			continue;
+		}
+		PackedAsset asset;
+		asset.path = it->path();
+		asset.name = it->path().lexically_relative(root).generic_string();
+		asset.entry.hash = AssetPack::hash(asset.name);
+		asset.entry.size = it->file_size();
+		assets.push_back(asset);
+	}
+	if (error) {
+		printf("Unable to read directory \"%s\"! Error: %s\n", argv[1], error.message().c_str());
+		return 1;
+	}
+	std::sort(assets.begin(), assets.end(), [](const PackedAsset& a, const PackedAsset& b) {
+		return a.entry.hash != b.entry.hash ? a.entry.hash < b.entry.hash : a.name < b.name;
+	});
+
+	PackHeader header;
+	header.magic = AssetPack::PACK_MAGIC;
+	header.version = AssetPack::PACK_VERSION;
+	header.numEntries = static_cast<Uint32>(assets.size());
+	header.reserved = 0;
+	header.namesOffset = sizeof(PackHeader) + assets.size() * sizeof(PackEntry);
+	Uint64 nameOffset = 0;
+	for (auto& asset : assets) {
+		asset.entry.nameOffset = static_cast<Uint32>(nameOffset);
+		asset.entry.nameLength = static_cast<Uint32>(asset.name.size());
+		nameOffset += asset.name.size();
+	}
+	header.dataOffset = align(header.namesOffset + nameOffset);
+	Uint64 dataOffset = header.dataOffset;
+	for (auto& asset : assets) {
+		asset.entry.offset = dataOffset;
+		dataOffset = align(dataOffset + asset.entry.size);
+	}
+
+	std::string outputPath = output.string();
+	SDL_RWops* file = SDL_RWFromFile(outputPath.c_str(), "wb");
+	if (!file) {
+		printf("Unable to create \"%s\"! Error: %s\n", outputPath.c_str(), SDL_GetError());
+		return 1;
+	}
+	bool success = SDL_RWwrite(file, &header, sizeof(PackHeader), 1) == 1;
+	for (const auto& asset : assets) {
+		success = success && SDL_RWwrite(file, &asset.entry, sizeof(PackEntry), 1) == 1;
+	}
+	for (const auto& asset : assets) {
+		success = success && SDL_RWwrite(file, asset.name.data(), asset.name.size(), 1) == 1;
+	}
+	success = success && writePadding(file, header.namesOffset + nameOffset);
+	for (const auto& asset : assets) {
+		size_t size = 0;
+		void* data = SDL_LoadFile(asset.path.string().c_str(), &size);
+		if (!data || size != asset.entry.size) {
+			printf("Unable to read \"%s\"! Error: %s\n", asset.name.c_str(), SDL_GetError());
+			success = false;
+		} else if (size > 0) {
+			success = success && SDL_RWwrite(file, data, size, 1) == 1;
+		}
+		SDL_free(data);
+		success = success && writePadding(file, asset.entry.offset + asset.entry.size);
+		if (!success) {
+			break;
+		}
+	}
+	SDL_RWclose(file);
+	if (!success) {
+		printf("Failed to write asset pack \"%s\"!\n", outputPath.c_str());
+		return 1;
+	}
+	printf("Packed %u assets into \"%s\" (%llu bytes)!\n", header.numEntries, outputPath.c_str(), static_cast<unsigned long long>(dataOffset));
+	return 0;
+}
@@ -0,0 +1,220 @@
+#include <core/Scene.h>
+#include <stdio.h>
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <vector>
+
+// Scene source is one declaration per line, '#' starts a comment:
+//   texture <name> <path>
+//   layer <name> <depth>
+//   collider <name> rect <x> <y> <w> <h>
+//   collider <name> circle <x> <y> <radius>
+//   entity <name> <layer> <x> <y> <w> <h> [texture=<name>] [collider=<name>] [color=RRGGBBAA]
+
+struct SceneBuilder {
+public:
+	Uint32 addString(const std::string& value) {
+		auto it = stringOffsets.find(value);
+		if (it != stringOffsets.end()) {
+			return it->second;
+		}
+		Uint32 offset = static_cast<Uint32>(strings.size());
+		strings.insert(strings.end(), value.begin(), value.end());
+		strings.push_back('\0');
+		stringOffsets[value] = offset;
+		return offset;
+	}
+
+	bool parseLine(const std::string& line, int lineNumber) {
+		std::istringstream stream(line.substr(0, line.find('#')));
+		std::string keyword, name;
+		if (!(stream >> keyword)) {
+			return true;
+		}
+		if (!(stream >> name)) {
+			return error(lineNumber, "missing name");
+		}
+		if (keyword == "texture") {
+			std::string path;
+			if (!(stream >> path) || textureIndices.count(name)) {
+				return error(lineNumber, "bad or duplicate texture");
+			}
+			textureIndices[name] = static_cast<Sint32>(textures.size());
+			textures.push_back(SceneTexture{addString(name), addString(path)});
+		} else if (keyword == "layer") {
+			SceneLayer layer{addString(name), 0, 0, 0};
+			if (!(stream >> layer.depth) || layerIndices.count(name)) {
+				return error(lineNumber, "bad or duplicate layer");
+			}
+			layerIndices[name] = static_cast<Uint32>(layers.size());
+			layers.push_back(layer);
+		} else if (keyword == "collider") {
+			std::string shape;
+			SceneCollider collider;
+			SDL_zero(collider);
+			stream >> shape >> collider.bounds.x >> collider.bounds.y >> collider.bounds.w;
+			if (shape == "rect") {
+				collider.shape = SCENE_COLLIDER_RECT;
+				stream >> collider.bounds.h;
+			} else if (shape == "circle") {
+				collider.shape = SCENE_COLLIDER_CIRCLE;
+				collider.bounds.h = collider.bounds.w;
+			} else {
+				return error(lineNumber, "unknown collider shape");
+			}
+			if (!stream || colliderIndices.count(name)) {
+				return error(lineNumber, "bad or duplicate collider");
+			}
+			colliderIndices[name] = static_cast<Sint32>(colliders.size());
+			colliders.push_back(collider);
+		} else if (keyword == "entity") {
+			std::string layerName, option;
+			SceneEntity entity;
+			entity.nameOffset = addString(name);
+			entity.texture = -1;
+			entity.collider = -1;
+			entity.color = SDL_Color{0xFF, 0xFF, 0xFF, 0xFF};
+			stream >> layerName >> entity.rect.x >> entity.rect.y >> entity.rect.w >> entity.rect.h;
+			if (!stream || !layerIndices.count(layerName)) {
+				return error(lineNumber, "bad entity or unknown layer");
+			}
+			entity.layer = layerIndices[layerName];
+			while (stream >> option) {
+				size_t separator = option.find('=');
+				std::string key = option.substr(0, separator);
+				std::string value = separator == std::string::npos ? "" : option.substr(separator + 1);
+				if (key == "texture" && textureIndices.count(value)) {
+					entity.texture = textureIndices[value];
+				} else if (key == "collider" && colliderIndices.count(value)) {
+					entity.collider = colliderIndices[value];
+				} else if (key == "color" && value.size() == 8) {
+					Uint32 rgba = static_cast<Uint32>(strtoul(value.c_str(), nullptr, 16));
+					entity.color = SDL_Color{static_cast<Uint8>(rgba >> 24), static_cast<Uint8>(rgba >> 16), static_cast<Uint8>(rgba >> 8), static_cast<Uint8>(rgba)};
+				} else {
+					return error(lineNumber, "unknown entity option");
+				}
+			}
+			entities.push_back(entity);
+		} else {
+			return error(lineNumber, "unknown declaration");
+		}
+		return true;
+	}
+
+	void sortEntities() {
+		std::vector<Uint32> order(layers.size());
+		for (Uint32 i = 0; i < order.size(); i++) {
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [this](Uint32 a, Uint32 b) {
+			return layers[a].depth < layers[b].depth;
+		});
+		std::vector<Uint32> remap(layers.size());
+		std::vector<SceneLayer> sortedLayers;
+		for (Uint32 i = 0; i < order.size(); i++) {
+			remap[order[i]] = i;
+			sortedLayers.push_back(layers[order[i]]);
+		}
+		for (auto& entity : entities) {
+			entity.layer = remap[entity.layer];
+		}
+		std::stable_sort(entities.begin(), entities.end(), [](const SceneEntity& a, const SceneEntity& b) {
+			return a.layer < b.layer;
+		});
+		for (Uint32 i = 0; i < entities.size(); i++) {
+			SceneLayer& layer = sortedLayers[entities[i].layer];
+			if (layer.numEntities == 0) {
+				layer.firstEntity = i;
+			}
+			layer.numEntities++;
+		}
+		layers.swap(sortedLayers);
+	}
+
+	bool write(const char* path) {
+		SceneHeader header;
+		SDL_zero(header);
+		header.magic = Scene::SCENE_MAGIC;
+		header.version = Scene::SCENE_VERSION;
+		header.numTextures = static_cast<Uint32>(textures.size());
+		header.numLayers = static_cast<Uint32>(layers.size());
+		header.numEntities = static_cast<Uint32>(entities.size());
+		header.numColliders = static_cast<Uint32>(colliders.size());
+		header.texturesOffset = sizeof(SceneHeader);
+		header.layersOffset = header.texturesOffset + header.numTextures * sizeof(SceneTexture);
+		header.entitiesOffset = header.layersOffset + header.numLayers * sizeof(SceneLayer);
+		header.collidersOffset = header.entitiesOffset + header.numEntities * sizeof(SceneEntity);
+		header.stringsOffset = header.collidersOffset + header.numColliders * sizeof(SceneCollider);
+		if (strings.empty()) {
+			strings.push_back('\0');
+		}
+		header.size = header.stringsOffset + static_cast<Uint32>(strings.size());
+
+		SDL_RWops* file = SDL_RWFromFile(path, "wb");
+		if (!file) {
+			printf("Unable to create \"%s\"! Error: %s\n", path, SDL_GetError());
+			return false;
+		}
+		bool success = SDL_RWwrite(file, &header, sizeof(SceneHeader), 1) == 1;
+		success = success && (textures.empty() || SDL_RWwrite(file, textures.data(), sizeof(SceneTexture), textures.size()) == textures.size());
+		success = success && (layers.empty() || SDL_RWwrite(file, layers.data(), sizeof(SceneLayer), layers.size()) == layers.size());
+		success = success && (entities.empty() || SDL_RWwrite(file, entities.data(), sizeof(SceneEntity), entities.size()) == entities.size());
+		success = success && (colliders.empty() || SDL_RWwrite(file, colliders.data(), sizeof(SceneCollider), colliders.size()) == colliders.size());
+		success = success && SDL_RWwrite(file, strings.data(), strings.size(), 1) == 1;
+		SDL_RWclose(file);
+		return success;
+	}
+
+private:
+	bool error(int lineNumber, const char* message) {
+		printf("Line %d: %s!\n", lineNumber, message);
+		return false;
+	}
+
+public:
+	std::vector<SceneTexture> textures;
+	std::vector<SceneLayer> layers;
+	std::vector<SceneEntity> entities;
+	std::vector<SceneCollider> colliders;
+	std::vector<char> strings;
+
+private:
+	std::map<std::string, Uint32> stringOffsets;
+	std::map<std::string, Sint32> textureIndices;
+	std::map<std::string, Uint32> layerIndices;
+	std::map<std::string, Sint32> colliderIndices;
+};
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		printf("Usage: %s <scene source> <output scene>\n", argv[0]);
+		return 1;
+	}
+	size_t size = 0;
+	char* source = static_cast<char*>(SDL_LoadFile(argv[1], &size));
+	if (!source) {
+		printf("Unable to read \"%s\"! Error: %s\n", argv[1], SDL_GetError());
+		return 1;
+	}
+	std::istringstream lines(std::string(source, size));
+	SDL_free(source);
+
+	SceneBuilder builder;
+	std::string line;
+	bool success = true;
+	for (int lineNumber = 1; success && std::getline(lines, line); lineNumber++) {
+		success = builder.parseLine(line, lineNumber);
+	}
+	if (!success) {
+		printf("Failed to parse \"%s\"!\n", argv[1]);
+		return 1;
+	}
+	builder.sortEntities();
+	if (!builder.write(argv[2])) {
+		printf("Failed to write scene \"%s\"!\n", argv[2]);
+		return 1;
+	}
+	printf("Compiled %zu entities in %zu layers into \"%s\"!\n", builder.entities.size(), builder.layers.size(), argv[2]);
+	return 0;
+}
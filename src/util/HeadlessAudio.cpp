@@ -0,0 +1,34 @@
+#include <util/HeadlessAudio.h>
+#include <stdio.h>
+
+bool HeadlessAudio::enabled = false;
+
+bool HeadlessAudio::enable(std::string outputPath, bool realTime) {
+	if (SDL_WasInit(SDL_INIT_AUDIO)) {
+		printf("Warning: Audio is already initialized, headless audio ignored!\n");
+		return false;
+	}
+	if (outputPath.empty()) {
+		SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+	} else {
+		SDL_setenv("SDL_AUDIODRIVER", "disk", 1);
+		SDL_setenv("SDL_DISKAUDIOFILE", outputPath.c_str(), 1);
+		if (!realTime) {
+			SDL_setenv("SDL_DISKAUDIODELAY", "0", 1);
+		}
+	}
+	enabled = true;
+	return true;
+}
+
+bool HeadlessAudio::enableFromEnvironment() {
+	const char* outputPath = SDL_getenv(HEADLESS_AUDIO_VARIABLE);
+	if (!outputPath) {
+		return false;
+	}
+	return enable(outputPath);
+}
+
+bool HeadlessAudio::isEnabled() {
+	return enabled;
+}
@@ -0,0 +1,236 @@
+#include <util/InputRecorder.h>
+#include <stdio.h>
+#include <string.h>
+
+InputRecorder::Mode InputRecorder::mode = InputRecorder::MODE_NONE;
+std::string InputRecorder::path;
+std::vector<Uint8> InputRecorder::records;
+Uint32 InputRecorder::numRecords = 0;
+Uint32 InputRecorder::currentFrame = 0;
+size_t InputRecorder::replayOffset = 0;
+bool InputRecorder::replaying = false;
+bool InputRecorder::attached = false;
+Uint64 InputRecorder::attachedCounter = 0;
+Uint32 InputRecorder::attachedFrame = 0;
+SDL_SpinLock InputRecorder::recordLock = 0;
+bool InputRecorder::recordsFull = false;
+
+bool InputRecorder::parseArguments(int argc, char** argv) {
+	for (int i = 1; i < argc; i++) {
+		bool record = strcmp(argv[i], "--record") == 0;
+		bool replay = strcmp(argv[i], "--replay") == 0;
+		if ((record || replay) && i + 1 >= argc) {
+			printf("Missing input recording path after \"%s\"!\n", argv[i]);
+			return false;
+		}
+		if (record) {
+			return startRecording(argv[++i]);
+		} else if (replay) {
+			return startReplay(argv[++i]);
+		}
+	}
+	return true;
+}
+
+bool InputRecorder::startRecording(std::string path) {
+	InputRecorder::path = path;
+	records.clear();
+	numRecords = 0;
+	currentFrame = 0;
+	recordsFull = false;
+	mode = MODE_RECORDING;
+	printf("Recording input to \"%s\"!\n", path.c_str());
+	return true;
+}
+
+bool InputRecorder::startReplay(std::string path) {
+	size_t size = 0;
+	Uint8* data = static_cast<Uint8*>(SDL_LoadFile(path.c_str(), &size));
+	if (!data) {
+		printf("Unable to open input recording \"%s\"! Error: %s\n", path.c_str(), SDL_GetError());
+		return false;
+	}
+	InputRecordHeader header;
+	if (size < sizeof(InputRecordHeader)) {
+		SDL_zero(header);
+	} else {
+		SDL_memcpy(&header, data, sizeof(InputRecordHeader));
+	}
+	if (header.magic != INPUT_MAGIC || header.version != INPUT_VERSION) {
+		printf("\"%s\" is not an input recording!\n", path.c_str());
+		SDL_free(data);
+		return false;
+	}
+	InputRecorder::path = path;
+	records.assign(data + sizeof(InputRecordHeader), data + size);
+	SDL_free(data);
+	numRecords = header.numRecords;
+	currentFrame = 0;
+	replayOffset = 0;
+	mode = MODE_REPLAYING;
+	printf("Replaying %u input events over %u frames from \"%s\"!\n", header.numRecords, header.numFrames, path.c_str());
+	return true;
+}
+
+void InputRecorder::attach() {
+	if (mode == MODE_NONE || attached) {
+		return;
+	}
+	SDL_SetEventFilter(filterEvent, nullptr);
+	attached = true;
+	attachedCounter = SDL_GetPerformanceCounter();
+	attachedFrame = currentFrame;
+}
+
+void InputRecorder::detach() {
+	if (!attached) {
+		return;
+	}
+	SDL_SetEventFilter(nullptr, nullptr);
+	attached = false;
+	Uint32 numFrames = currentFrame - attachedFrame;
+	double seconds = static_cast<double>(SDL_GetPerformanceCounter() - attachedCounter) / SDL_GetPerformanceFrequency();
+	if (mode == MODE_RECORDING) {
+		// Events pushed from other threads may still be inside the filter.
+		SDL_AtomicLock(&recordLock);
+		bool saved = save();
+		SDL_AtomicUnlock(&recordLock);
+		if (!saved) {
+			printf("Unable to save input recording \"%s\"! Error: %s\n", path.c_str(), SDL_GetError());
+		}
+	} else if (numFrames > 0 && seconds > 0) {
+		printf("Replayed %u frames in %.3f s (%.2f ms/frame, %.1f fps)!\n", numFrames, seconds, seconds * 1000.0 / numFrames, numFrames / seconds);
+	}
+}
+
+void InputRecorder::frame() {
+	if (!attached) {
+		return;
+	}
+	currentFrame++;
+	if (mode != MODE_REPLAYING) {
+		return;
+	}
+	replaying = true;
+	while (replayOffset + sizeof(Uint32) + 1 <= records.size()) {
+		Uint32 frame;
+		SDL_memcpy(&frame, &records[replayOffset], sizeof(Uint32));
+		size_t size = records[replayOffset + sizeof(Uint32)];
+		size_t start = replayOffset + sizeof(Uint32) + 1;
+		if (frame > currentFrame || start + size > records.size()) {
+			break;
+		}
+		SDL_Event event;
+		SDL_zero(event);
+		SDL_memcpy(&event, &records[start], SDL_min(size, sizeof(SDL_Event)));
+		SDL_PushEvent(&event);
+		replayOffset = start + size;
+	}
+	replaying = false;
+}
+
+bool InputRecorder::isRecording() {
+	return mode == MODE_RECORDING;
+}
+
+bool InputRecorder::isReplaying() {
+	return mode == MODE_REPLAYING;
+}
+
+int SDLCALL InputRecorder::filterEvent(void*, SDL_Event* event) {
+	size_t size = getRecordedSize(event->type);
+	if (size == 0) {
+		return 1;
+	}
+	if (mode == MODE_REPLAYING) {
+		return replaying || event->type == SDL_QUIT;
+	}
+	if (mode != MODE_RECORDING || !attached) {
+		return 1;
+	}
+	// The filter runs on whichever thread pushes the event.
+	SDL_AtomicLock(&recordLock);
+	size_t offset = records.size();
+	size_t recordSize = sizeof(Uint32) + 1 + size;
+	if (recordSize > MAX_RECORDS_SIZE - offset) {
+		if (!recordsFull) {
+			printf("Warning: Input recording is full, later events are not recorded!\n");
+			recordsFull = true;
+		}
+	} else {
+		records.resize(offset + recordSize);
+		SDL_memcpy(&records[offset], &currentFrame, sizeof(Uint32));
+		records[offset + sizeof(Uint32)] = static_cast<Uint8>(size);
+		SDL_memcpy(&records[offset + sizeof(Uint32) + 1], event, size);
+		numRecords++;
+	}
+	SDL_AtomicUnlock(&recordLock);
+	return 1;
+}
+
+size_t InputRecorder::getRecordedSize(Uint32 type) {
+	switch (type) {
+		case SDL_QUIT: {
+			return sizeof(SDL_QuitEvent);
+		}
+		case SDL_KEYDOWN:
+		case SDL_KEYUP: {
+			return sizeof(SDL_KeyboardEvent);
+		}
+		case SDL_TEXTEDITING: {
+			return sizeof(SDL_TextEditingEvent);
+		}
+		case SDL_TEXTINPUT: {
+			return sizeof(SDL_TextInputEvent);
+		}
+		case SDL_MOUSEMOTION: {
+			return sizeof(SDL_MouseMotionEvent);
+		}
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP: {
+			return sizeof(SDL_MouseButtonEvent);
+		}
+		case SDL_MOUSEWHEEL: {
+			return sizeof(SDL_MouseWheelEvent);
+		}
+		case SDL_JOYAXISMOTION: {
+			return sizeof(SDL_JoyAxisEvent);
+		}
+		case SDL_JOYBALLMOTION: {
+			return sizeof(SDL_JoyBallEvent);
+		}
+		case SDL_JOYHATMOTION: {
+			return sizeof(SDL_JoyHatEvent);
+		}
+		case SDL_JOYBUTTONDOWN:
+		case SDL_JOYBUTTONUP: {
+			return sizeof(SDL_JoyButtonEvent);
+		}
+		case SDL_CONTROLLERAXISMOTION: {
+			return sizeof(SDL_ControllerAxisEvent);
+		}
+		case SDL_CONTROLLERBUTTONDOWN:
+		case SDL_CONTROLLERBUTTONUP: {
+			return sizeof(SDL_ControllerButtonEvent);
+		}
+		default: {
+			return 0;
+		}
+	}
+}
+
+bool InputRecorder::save() {
+	InputRecordHeader header;
+	header.magic = INPUT_MAGIC;
+	header.version = INPUT_VERSION;
+	header.numRecords = numRecords;
+	header.numFrames = currentFrame;
+	SDL_RWops* file = SDL_RWFromFile(path.c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	bool success = SDL_RWwrite(file, &header, sizeof(InputRecordHeader), 1) == 1;
+	success = success && (records.empty() || SDL_RWwrite(file, records.data(), records.size(), 1) == 1);
+	SDL_RWclose(file);
+	return success;
+}
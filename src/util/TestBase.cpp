@@ -1,4 +1,8 @@
 #include <util/TestBase.h>
+#include <util/HeadlessAudio.h>
+#include <util/InputRecorder.h>
+#include <core/AssetPack.h>
+#include <core/JobSystem.h>
 #include <stdio.h>
 
 std::string TestBase::name() {
@@ -6,16 +10,22 @@ std::string TestBase::name() {
 }
 
 void TestBase::test() {
+	AssetPack::mount(ASSET_PACK_PATH);
+	JobSystem::init();
 	if (!init()) {
 		printf("Failed to initialize!\n");
 	} else {
 		if (!loadMedia()) {
 			printf("Failed to load media!\n");
 		} else {
+			InputRecorder::attach();
 			run();
+			InputRecorder::detach();
 		}
 	}
 	close();
+	JobSystem::quit();
+	AssetPack::unmount();
 }
 
 bool BasicTestBase::init() {
@@ -38,6 +48,7 @@ bool BasicTestBase::init() {
 				success = false;
 			} else {
 				SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+				enableTiledRenderer();
 				int imgFlags = IMG_INIT_PNG;
 				if (!(IMG_Init(imgFlags) & imgFlags)) {
 					printf("SDL2_image could not initialize! Error: %s\n", IMG_GetError());
@@ -58,18 +69,24 @@ void BasicTestBase::run() {
 	bool quit = false;
 	SDL_Event e;
 	while (!quit) {
+		InputRecorder::frame();
+		bool draw = waitForFrame();
 		while (SDL_PollEvent(&e) != 0) {
 			if (e.type == SDL_QUIT) {
 				quit = true;
 			}
 		}
-		SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-		SDL_RenderClear(renderer);
-		SDL_RenderPresent(renderer);
+		if (draw) {
+			TiledRenderer::setDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+			TiledRenderer::clear(renderer);
+			TiledRenderer::present(renderer);
+		}
 	}
 }
 
 void BasicTestBase::close() {
+	tiledRenderer.printStatistics();
+	tiledRenderer.free();
 	SDL_DestroyRenderer(renderer);
 	renderer = nullptr;
 	SDL_DestroyWindow(window);
@@ -82,6 +99,140 @@ std::string BasicTestBase::name() {
 	return "Basic Test";
 }
 
+bool BasicTestBase::supportsTiledRenderer() {
+	return true;
+}
+
+void BasicTestBase::enableTiledRenderer() {
+	if (supportsTiledRenderer() && TiledRenderer::shouldEnable(renderer) && tiledRenderer.init(renderer, WINDOW_WIDTH, WINDOW_HEIGHT)) {
+		printf("Rendering through the tiled software renderer on %d threads!\n", tiledRenderer.getNumThreads());
+	}
+}
+
+void BasicTestBase::runSimulation(int stepsPerSecond) {
+	bool quit = false;
+	SDL_Event e;
+	stepTicks = SDL_max(SDL_GetPerformanceFrequency() / stepsPerSecond, 1);
+	SDL_AtomicSet(&simulationRunning, 1);
+	SDL_Thread* thread = nullptr;
+	if (SDL_getenv(SIMULATION_THREAD_VARIABLE)) {
+		thread = SDL_CreateThread(simulationThread, "Simulation", this);
+		if (!thread) {
+			printf("Warning: Unable to create simulation thread! Error: %s\n", SDL_GetError());
+		} else {
+			printf("Simulating on a separate thread at %d steps per second!\n", stepsPerSecond);
+		}
+	}
+	numSimulatedSteps = 0;
+	Uint64 start = SDL_GetPerformanceCounter();
+	Uint64 nextStep = start;
+	std::vector<SDL_Event> events;
+	while (!quit) {
+		InputRecorder::frame();
+		while (SDL_PollEvent(&e) != 0) {
+			if (e.type == SDL_QUIT) {
+				quit = true;
+			} else {
+				SDL_AtomicLock(&eventLock);
+				pendingEvents.push_back(e);
+				SDL_AtomicUnlock(&eventLock);
+			}
+		}
+		if (!thread) {
+			Uint64 now = SDL_GetPerformanceCounter();
+			if (now > nextStep && now - nextStep > stepTicks * MAX_STEPS_BEHIND) {
+				nextStep = now - stepTicks * MAX_STEPS_BEHIND;
+			}
+			while (nextStep <= now) {
+				step(events);
+				nextStep += stepTicks;
+			}
+		}
+		renderSnapshot();
+	}
+	if (thread) {
+		SDL_AtomicSet(&simulationRunning, 0);
+		SDL_WaitThread(thread, nullptr);
+	}
+	pendingEvents.clear();
+	checkStepRate(stepsPerSecond, SDL_GetPerformanceCounter() - start);
+}
+
+void BasicTestBase::simulate(std::vector<SDL_Event>&) {
+}
+
+void BasicTestBase::renderSnapshot() {
+}
+
+bool BasicTestBase::waitForFrame() {
+	if (!SDL_getenv(ON_DEMAND_RENDERING_VARIABLE) || animating || InputRecorder::isRecording() || InputRecorder::isReplaying()) {
+		return true;
+	}
+	// Any queued event may change the frame, so it is drawn after the event
+	// is handled. The timeout only bounds how long the loop sleeps.
+	if (!redraw && SDL_WaitEventTimeout(nullptr, IDLE_TIMEOUT) == 1) {
+		redraw = true;
+	}
+	bool draw = redraw;
+	redraw = false;
+	return draw;
+}
+
+void BasicTestBase::invalidate() {
+	redraw = true;
+}
+
+void BasicTestBase::setAnimating(bool animating) {
+	this->animating = animating;
+	redraw = true;
+}
+
+void BasicTestBase::step(std::vector<SDL_Event>& events) {
+	// Input that arrived since the last step is handed to this step, so both
+	// loops apply it at the same point of the simulation.
+	SDL_AtomicLock(&eventLock);
+	events.swap(pendingEvents);
+	SDL_AtomicUnlock(&eventLock);
+	simulate(events);
+	events.clear();
+	numSimulatedSteps++;
+}
+
+void BasicTestBase::checkStepRate(int stepsPerSecond, Uint64 elapsedTicks) {
+	double seconds = static_cast<double>(elapsedTicks) / SDL_GetPerformanceFrequency();
+	if (seconds < 1.0) {
+		return;
+	}
+	double rate = numSimulatedSteps / seconds;
+	printf("Simulation: %llu steps, %.1f steps per second\n", static_cast<unsigned long long>(numSimulatedSteps), rate);
+	if (SDL_fabs(rate - stepsPerSecond) > stepsPerSecond * STEP_RATE_TOLERANCE) {
+		printf("Warning: Simulation ran at %.1f steps per second instead of %d!\n", rate, stepsPerSecond);
+	}
+}
+
+int BasicTestBase::simulationThread(void* data) {
+	static_cast<BasicTestBase*>(data)->runSimulationSteps();
+	return 0;
+}
+
+void BasicTestBase::runSimulationSteps() {
+	std::vector<SDL_Event> events;
+	Uint64 frequency = SDL_GetPerformanceFrequency();
+	Uint64 nextStep = SDL_GetPerformanceCounter();
+	while (SDL_AtomicGet(&simulationRunning)) {
+		step(events);
+		nextStep += stepTicks;
+		Uint64 now = SDL_GetPerformanceCounter();
+		if (now < nextStep) {
+			SDL_Delay(static_cast<Uint32>((nextStep - now) * 1000 / frequency));
+		} else if (now - nextStep > stepTicks * MAX_STEPS_BEHIND) {
+			// Too slow to catch up; drop the missed steps instead of running
+			// them back to back.
+			nextStep = now;
+		}
+	}
+}
+
 bool BasicTestBaseWithTTF::init() {
 	bool success = BasicTestBase::init();
 	if (TTF_Init() == -1) {
@@ -102,6 +253,9 @@ std::string BasicTestBaseWithTTF::name() {
 
 bool BasicTestBaseWithAudio::init() {
 	bool success = true;
+	if (HeadlessAudio::enableFromEnvironment()) {
+		printf("Running with headless audio!\n");
+	}
 	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
 		printf("SDL could not initialize! Error: %s\n", SDL_GetError());
 		success = false;
@@ -120,6 +274,7 @@ bool BasicTestBaseWithAudio::init() {
 				success = false;
 			} else {
 				SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+				enableTiledRenderer();
 				int imgFlags = IMG_INIT_PNG;
 				if (!(IMG_Init(imgFlags) & imgFlags)) {
 					printf("SDL2_image could not initialize! Error: %s\n", IMG_GetError());
@@ -192,6 +347,7 @@ bool BasicTestBaseWithController::init() {
 				success = false;
 			} else {
 				SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+				enableTiledRenderer();
 				int imgFlags = IMG_INIT_PNG;
 				if (!(IMG_Init(imgFlags) & imgFlags)) {
 					printf("SDL2_image could not initialize! Error: %s\n", IMG_GetError());